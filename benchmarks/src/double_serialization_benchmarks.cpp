@@ -0,0 +1,90 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures serializing arrays of doubles, as parsed from text with a few
+// digits, as computed with full precision, and with a fixed precision
+// option.
+
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+// A time series with values of three decimal places
+json make_parsed_series(size_t n)
+{
+    std::string s = "[";
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        s += std::to_string(1000 + (i*7919) % 100000 / 1000) + "." + std::to_string(100 + (i*104729) % 900);
+    }
+    s.push_back(']');
+    return json::parse(s);
+}
+
+json make_computed_series(size_t n)
+{
+    json a = json::array();
+    a.reserve(n);
+    double x = 0.5;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x = 3.9 * x * (1 - x);
+        a.push_back(x * 1000.0);
+    }
+    return a;
+}
+
+void run(const std::string& name, const json& j, const serialization_options& options)
+{
+    const size_t repeat = 5;
+    size_t length = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        std::ostringstream os;
+        j.dump(os, options);
+        length += os.str().length();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+
+    std::cout << std::left << std::setw(36) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << length/repeat << std::endl;
+}
+
+}
+
+int main()
+{
+    const size_t n = 1000000;
+    json parsed = make_parsed_series(n);
+    json computed = make_computed_series(n);
+
+    serialization_options options;
+    serialization_options precision6;
+    precision6.precision(6);
+    serialization_options precision17;
+    precision17.precision(17);
+
+    std::cout << std::left << std::setw(36) << "1M doubles"
+              << std::right
+              << std::setw(12) << "dump ms"
+              << std::setw(14) << "bytes" << std::endl;
+    run("parsed, 7 digits", parsed, options);
+    run("computed, 15 digits", computed, options);
+    run("computed, precision 6", computed, precision6);
+    run("computed, precision 17", computed, precision17);
+}
@@ -0,0 +1,88 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures writing documents with large string values to a file descriptor,
+// copying the strings into the sink's buffer, and passing them to writev by
+// reference.
+
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <cstdio>
+#include <fcntl.h>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons/output_sink.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+json make_blobs(size_t count, size_t length)
+{
+    json a = json::array();
+    for (size_t i = 0; i < count; ++i)
+    {
+        json record;
+        record["id"] = i;
+        record["content_type"] = "text/plain";
+        record["body"] = std::string(length, static_cast<char>('a' + i % 26));
+        a.push_back(std::move(record));
+    }
+    return a;
+}
+
+void run(const std::string& name, const json& j, int fd, size_t min_reference_length)
+{
+    const size_t repeat = 20;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        fd_sink sink(fd, fd_sink::default_buffer_length, min_reference_length);
+        j.dump(sink);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+
+    std::cout << std::left << std::setw(40) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(2) << ms << std::endl;
+}
+
+}
+
+int main()
+{
+#if defined(_WIN32)
+    int fd = _open("NUL", _O_WRONLY);
+#else
+    int fd = open("/dev/null", O_WRONLY);
+#endif
+    if (fd < 0)
+    {
+        std::cerr << "Cannot open the null device" << std::endl;
+        return 1;
+    }
+
+    json large = make_blobs(16, 4*1024*1024);
+    json medium = make_blobs(1024, 64*1024);
+
+    std::cout << std::left << std::setw(40) << "to the null device"
+              << std::right
+              << std::setw(12) << "dump ms" << std::endl;
+    run("16 x 4 MB strings, copied", large, fd, 0);
+    run("16 x 4 MB strings, by reference", large, fd, 4096);
+    run("1024 x 64 KB strings, copied", medium, fd, 0);
+    run("1024 x 64 KB strings, by reference", medium, fd, 4096);
+
+#if defined(_WIN32)
+    _close(fd);
+#else
+    close(fd);
+#endif
+}
@@ -0,0 +1,82 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures serializing integer-heavy documents: small counters, ids and
+// epoch timestamps in milliseconds.
+
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+json make_records(size_t n)
+{
+    json a = json::array();
+    a.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        json record;
+        record["id"] = static_cast<uint64_t>(1000000007u + (i*7919) % 1000000);
+        record["count"] = static_cast<int64_t>(i % 100);
+        record["delta"] = -static_cast<int64_t>((i*104729) % 5000);
+        record["timestamp"] = static_cast<int64_t>(1500000000000 + i*1000);
+        a.push_back(std::move(record));
+    }
+    return a;
+}
+
+json make_integers(size_t n)
+{
+    json a = json::array();
+    a.reserve(n);
+    uint64_t x = 88172645463325252u;
+    for (size_t i = 0; i < n; ++i)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        a.push_back(static_cast<int64_t>(x >> (i % 64)));
+    }
+    return a;
+}
+
+void run(const std::string& name, const json& j)
+{
+    const size_t repeat = 5;
+    size_t length = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        std::ostringstream os;
+        j.dump(os);
+        length += os.str().length();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+
+    std::cout << std::left << std::setw(36) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << length/repeat << std::endl;
+}
+
+}
+
+int main()
+{
+    json records = make_records(500000);
+    json integers = make_integers(2000000);
+
+    std::cout << std::left << std::setw(36) << "document"
+              << std::right
+              << std::setw(12) << "dump ms"
+              << std::setw(14) << "bytes" << std::endl;
+    run("500K records of 4 integers", records);
+    run("2M integers of 1 to 19 digits", integers);
+}
@@ -0,0 +1,119 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Compares looking up records in an array of objects by id with a jsonpath
+// filter that scans the array, the same filter answered from a json_index,
+// and json_index::find.
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_index.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+json make_users(size_t n)
+{
+    json users = json::array();
+    users.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        json::object_builder builder;
+        builder.push_back("id", i);
+        builder.push_back("name", "user" + std::to_string(i));
+        builder.push_back("active", i % 2 == 0);
+        users.push_back(builder.build());
+    }
+    json root;
+    root["users"] = std::move(users);
+    return root;
+}
+
+template <class F>
+long long time_us(F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end-start).count();
+}
+
+void report(const std::string& name, long long us, size_t lookups)
+{
+    std::cout << std::left << std::setw(32) << name
+              << std::right
+              << std::setw(14) << us
+              << std::setw(16) << std::fixed << std::setprecision(2) << double(us)/lookups << std::endl;
+}
+
+void run(size_t n, size_t lookups)
+{
+    const json root = make_users(n);
+    const json& users = root.at("users");
+
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < lookups; ++i)
+    {
+        paths.push_back("$.users[?(@.id == " + std::to_string((i*7919) % n) + ")]");
+    }
+
+    std::cout << n << " users, " << lookups << " lookups" << std::endl;
+    std::cout << std::left << std::setw(32) << "method"
+              << std::right
+              << std::setw(14) << "total us"
+              << std::setw(16) << "us per lookup" << std::endl;
+
+    size_t found = 0;
+    long long us = time_us([&]()
+    {
+        for (const auto& path : paths)
+        {
+            found += jsonpath::json_query(root, path).size();
+        }
+    });
+    report("json_query scan", us, lookups);
+
+    json_index* index = nullptr;
+    us = time_us([&](){index = new json_index(users, "id");});
+    report("build index", us, 1);
+
+    std::vector<const json_index*> indexes = {index};
+    us = time_us([&]()
+    {
+        for (const auto& path : paths)
+        {
+            found += jsonpath::json_query(root, path, indexes).size();
+        }
+    });
+    report("json_query with index", us, lookups);
+
+    us = time_us([&]()
+    {
+        for (size_t i = 0; i < lookups; ++i)
+        {
+            found += index->find(json((i*7919) % n)).size();
+        }
+    });
+    report("json_index::find", us, lookups);
+    delete index;
+
+    if (found != 3*lookups)
+    {
+        std::cout << "unexpected number of matches " << found << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+}
+
+int main()
+{
+    run(1000, 1000);
+    run(100000, 100);
+}
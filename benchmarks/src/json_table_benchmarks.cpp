@@ -0,0 +1,100 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Compares an array of records with the same member names held as a json
+// array of objects and as a json_table, in heap bytes and in the time to
+// sum and filter a numeric column.
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_table.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+json make_records(size_t n)
+{
+    json records = json::array();
+    records.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        json::object_builder builder;
+        builder.push_back("id", i);
+        builder.push_back("price", (i % 1000) * 0.25);
+        builder.push_back("quantity", static_cast<int64_t>(i % 17));
+        builder.push_back("category", i % 3 == 0 ? "books" : "music");
+        records.push_back(builder.build());
+    }
+    return records;
+}
+
+template <class F>
+long long time_ms(F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count();
+}
+
+void report(const std::string& name, size_t bytes, long long sum_ms, long long filter_ms)
+{
+    std::cout << std::left << std::setw(24) << name
+              << std::right
+              << std::setw(16) << bytes
+              << std::setw(12) << sum_ms
+              << std::setw(14) << filter_ms << std::endl;
+}
+
+void run(size_t n)
+{
+    const json records = make_records(n);
+    double sum = 0;
+    size_t count = 0;
+
+    std::cout << n << " records" << std::endl;
+    std::cout << std::left << std::setw(24) << "representation"
+              << std::right
+              << std::setw(16) << "heap bytes"
+              << std::setw(12) << "sum ms"
+              << std::setw(14) << "filter ms" << std::endl;
+
+    long long sum_ms = time_ms([&]()
+    {
+        for (const auto& record : records.array_range())
+        {
+            sum += record["price"].as<double>();
+        }
+    });
+    long long filter_ms = time_ms([&]()
+    {
+        for (const auto& record : records.array_range())
+        {
+            if (record["quantity"].as<int64_t>() == 5)
+            {
+                ++count;
+            }
+        }
+    });
+    report("array of objects", records.memory_footprint().total_bytes(), sum_ms, filter_ms);
+
+    const json_table table(records);
+    sum_ms = time_ms([&](){sum += table.sum<double>("price");});
+    filter_ms = time_ms([&](){count += table.filter<int64_t>("quantity",[](int64_t q){return q == 5;}).size();});
+    report("json_table", table.memory_footprint().total_bytes(), sum_ms, filter_ms);
+
+    std::cout << "(checksum " << sum << " " << count << ")" << std::endl << std::endl;
+}
+
+}
+
+int main()
+{
+    run(100000);
+    run(2000000);
+}
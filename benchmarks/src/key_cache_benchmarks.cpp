@@ -0,0 +1,80 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures serializing arrays of records that share member names, with and
+// without serialization_options::cache_escaped_keys.
+
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+const char* names[] = {"id", "first_name", "last_name", "email_address", "street",
+                       "city", "postal_code", "country", "phone", "active",
+                       "caf\xC3\xA9_visits", "r\xC3\xA9sum\xC3\xA9"};
+
+json make_records(size_t n)
+{
+    json a = json::array();
+    a.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        json record;
+        for (size_t k = 0; k < sizeof(names)/sizeof(names[0]); ++k)
+        {
+            record[names[k]] = (i*7919 + k) % 1000;
+        }
+        a.push_back(std::move(record));
+    }
+    return a;
+}
+
+void run(const std::string& name, const json& j, const serialization_options& options)
+{
+    const size_t repeat = 5;
+    size_t length = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        std::ostringstream os;
+        j.dump(os, options);
+        length += os.str().length();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+
+    std::cout << std::left << std::setw(40) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << length/repeat << std::endl;
+}
+
+}
+
+int main()
+{
+    json records = make_records(200000);
+
+    serialization_options options;
+    serialization_options cached;
+    cached.cache_escaped_keys(true);
+    serialization_options ascii;
+    ascii.escape_all_non_ascii(true);
+    serialization_options ascii_cached = ascii;
+    ascii_cached.cache_escaped_keys(true);
+
+    std::cout << std::left << std::setw(40) << "200K records of 12 members"
+              << std::right
+              << std::setw(12) << "dump ms"
+              << std::setw(14) << "bytes" << std::endl;
+    run("default", records, options);
+    run("cache_escaped_keys", records, cached);
+    run("escape_all_non_ascii", records, ascii);
+    run("escape_all_non_ascii, cache_escaped_keys", records, ascii_cached);
+}
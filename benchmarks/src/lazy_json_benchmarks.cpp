@@ -0,0 +1,96 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Compares reading a few values from a large document by parsing all of it
+// with json::parse and by parsing only what is read with lazy_json.
+
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+#include <jsoncons/lazy_json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+// An object of sections, each an object of settings with nested arrays
+std::string make_document(size_t sections, size_t settings)
+{
+    std::string s = "{";
+    for (size_t i = 0; i < sections; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        s += "\"section" + std::to_string(i) + "\":{";
+        for (size_t j = 0; j < settings; ++j)
+        {
+            if (j > 0)
+            {
+                s.push_back(',');
+            }
+            s += "\"setting" + std::to_string(j) + "\":{\"value\":" + std::to_string(i*j) 
+               + ",\"description\":\"a description of setting " + std::to_string(j) + "\",\"history\":[1.5,2.5,3.5,\"x\"]}";
+        }
+        s.push_back('}');
+    }
+    s.push_back('}');
+    return s;
+}
+
+template <class F>
+double time_ms(F f, size_t repeat)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        f();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+}
+
+void run(size_t sections, size_t settings)
+{
+    const std::string s = make_document(sections, settings);
+    const std::string section = "section" + std::to_string(sections/2);
+    const std::string setting = "setting" + std::to_string(settings/2);
+    int64_t sum = 0;
+    const size_t repeat = 5;
+
+    std::cout << std::fixed << std::setprecision(2) << s.size()/(1024.0*1024.0) << " MB document" << std::endl;
+
+    double full = time_ms([&]()
+    {
+        json j = json::parse(s);
+        sum += j[section][setting]["value"].as<int64_t>();
+        sum += j["section0"]["setting0"]["value"].as<int64_t>();
+    }, repeat);
+    double lazy = time_ms([&]()
+    {
+        lazy_json j = lazy_json::parse(s);
+        sum += j[section][setting]["value"].as<int64_t>();
+        sum += j["section0"]["setting0"]["value"].as<int64_t>();
+    }, repeat);
+    double skip = time_ms([&]()
+    {
+        lazy_json j = lazy_json::parse(s);
+        sum += j.raw().length();
+    }, repeat);
+
+    std::cout << std::left << std::setw(32) << "json::parse, 2 lookups" << std::right << std::setw(10) << full << " ms" << std::endl;
+    std::cout << std::left << std::setw(32) << "lazy_json, 2 lookups" << std::right << std::setw(10) << lazy << " ms" << std::endl;
+    std::cout << std::left << std::setw(32) << "lazy_json::parse only" << std::right << std::setw(10) << skip << " ms" << std::endl;
+    std::cout << "(checksum " << sum << ")" << std::endl << std::endl;
+}
+
+}
+
+int main()
+{
+    run(100, 100);
+    run(200, 1000);
+}
@@ -0,0 +1,233 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures the heap memory held by parsed json values on number-heavy
+// and string-heavy corpora, and compares it with the raw payload size
+// and with the bytes reported by memory_footprint.
+
+#include <cstdlib>
+#include <cstdio>
+#include <new>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+size_t live_bytes = 0;
+size_t allocation_count = 0;
+
+// Each block is prefixed with its size so that frees can be accounted for
+const size_t header_size = 16;
+
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = std::malloc(size + header_size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(p) = size;
+    live_bytes += size;
+    ++allocation_count;
+    return static_cast<char*>(p) + header_size;
+}
+
+void operator delete(void* p) JSONCONS_NOEXCEPT
+{
+    if (p != nullptr)
+    {
+        void* base = static_cast<char*>(p) - header_size;
+        live_bytes -= *static_cast<std::size_t*>(base);
+        std::free(base);
+    }
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* p) JSONCONS_NOEXCEPT
+{
+    operator delete(p);
+}
+
+struct packing_policy : public sorted_policy
+{
+    static const bool pack_numeric_arrays = true;
+};
+
+struct corpus
+{
+    std::string name;
+    std::string text;
+    size_t values;
+    size_t payload_bytes;
+};
+
+corpus make_double_array(size_t n)
+{
+    corpus c;
+    c.name = "array of doubles";
+    c.values = n;
+    c.payload_bytes = n*sizeof(double);
+    c.text.push_back('[');
+    char buf[64];
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            c.text.push_back(',');
+        }
+        int len = c99_snprintf(buf, sizeof(buf), "%.6f", 1000.0*std::sin(double(i)));
+        c.text.append(buf, len);
+    }
+    c.text.push_back(']');
+    return c;
+}
+
+corpus make_integer_array(size_t n)
+{
+    corpus c;
+    c.name = "array of integers";
+    c.values = n;
+    c.payload_bytes = n*sizeof(int64_t);
+    c.text.push_back('[');
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            c.text.push_back(',');
+        }
+        c.text.append(std::to_string(1500000000 + i*7));
+    }
+    c.text.push_back(']');
+    return c;
+}
+
+corpus make_string_array(size_t n, size_t length)
+{
+    corpus c;
+    c.name = "array of " + std::to_string(length) + " char strings";
+    c.values = n;
+    c.payload_bytes = n*length;
+    c.text.push_back('[');
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            c.text.push_back(',');
+        }
+        c.text.push_back('\"');
+        std::string s = std::to_string(i);
+        s.resize(length, 'x');
+        c.text.append(s);
+        c.text.push_back('\"');
+    }
+    c.text.push_back(']');
+    return c;
+}
+
+corpus make_pairs(size_t n)
+{
+    corpus c;
+    c.name = "array of [x,y] pairs";
+    c.values = 2*n;
+    c.payload_bytes = n*2*sizeof(double);
+    c.text.push_back('[');
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            c.text.push_back(',');
+        }
+        c.text.append("[" + std::to_string(i*0.5) + "," + std::to_string(i*0.25) + "]");
+    }
+    c.text.push_back(']');
+    return c;
+}
+
+corpus make_records(size_t n)
+{
+    corpus c;
+    c.name = "array of {id,name,score} records";
+    c.values = 3*n;
+    c.payload_bytes = n*(sizeof(int64_t) + 12 + sizeof(double) + 2 + 4 + 5);
+    c.text.push_back('[');
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            c.text.push_back(',');
+        }
+        std::string name = "user" + std::to_string(i);
+        name.resize(12,'_');
+        c.text.append("{\"id\":" + std::to_string(i) + ",\"name\":\"" + name + "\",\"score\":" + std::to_string(i*0.25) + "}");
+    }
+    c.text.push_back(']');
+    return c;
+}
+
+template <class Json>
+void measure(const corpus& c)
+{
+    size_t before = live_bytes;
+    size_t count_before = allocation_count;
+    auto start = std::chrono::high_resolution_clock::now();
+    Json j = Json::parse(c.text);
+    auto end = std::chrono::high_resolution_clock::now();
+    size_t held = live_bytes - before;
+    size_t allocations = allocation_count - count_before;
+
+    std::cout << std::left << std::setw(36) << c.name
+              << std::right
+              << std::setw(12) << held
+              << std::setw(12) << std::fixed << std::setprecision(1) << double(held)/c.values
+              << std::setw(12) << std::setprecision(2) << double(held)/c.payload_bytes
+              << std::setw(12) << allocations
+              << std::setw(10) << std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count()
+              << std::setw(12) << j.memory_footprint().total_bytes()
+              << std::endl;
+}
+
+template <class Json>
+void run(const char* name)
+{
+    const size_t n = 1000000;
+
+    std::cout << name << ": sizeof(value) = " << sizeof(Json)
+              << ", sizeof(array) = " << sizeof(typename Json::array)
+              << ", sizeof(object) = " << sizeof(typename Json::object)
+              << ", sizeof(member) = " << sizeof(typename Json::key_value_pair_type) << std::endl;
+    std::cout << std::left << std::setw(36) << "corpus"
+              << std::right
+              << std::setw(12) << "heap bytes"
+              << std::setw(12) << "per value"
+              << std::setw(12) << "x payload"
+              << std::setw(12) << "allocs"
+              << std::setw(10) << "parse ms"
+              << std::setw(12) << "footprint" << std::endl;
+
+    measure<Json>(make_double_array(n));
+    measure<Json>(make_integer_array(n));
+    measure<Json>(make_string_array(n,8));
+    measure<Json>(make_string_array(n,24));
+    measure<Json>(make_pairs(n/10));
+    measure<Json>(make_records(n/10));
+    std::cout << std::endl;
+}
+
+int main()
+{
+    run<json>("json");
+    run<ojson>("ojson");
+    run<basic_json<char,packing_policy>>("json with packed numeric arrays");
+    run<basic_json<char,small_storage_policy>>("json with small storage");
+}
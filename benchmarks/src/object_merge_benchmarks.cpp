@@ -0,0 +1,106 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Compares the single pass merge, merge_or_update and erase_keys of sorted
+// objects with inserting or erasing the same members one key at a time.
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+json make_object(size_t n, size_t stride, size_t offset)
+{
+    json::object_builder builder;
+    builder.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        builder.push_back("key" + std::to_string(i*stride + offset), i);
+    }
+    return builder.build();
+}
+
+template <class F>
+long long time_ms(F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    f();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count();
+}
+
+void report(const std::string& name, long long per_key, long long bulk)
+{
+    std::cout << std::left << std::setw(40) << name
+              << std::right
+              << std::setw(14) << per_key
+              << std::setw(14) << bulk << std::endl;
+}
+
+void run(size_t n)
+{
+    const json target = make_object(n, 2, 0);
+    const json source = make_object(n, 3, 1);
+
+    std::cout << n << " members in each object" << std::endl;
+    std::cout << std::left << std::setw(40) << "operation"
+              << std::right
+              << std::setw(14) << "per key ms"
+              << std::setw(14) << "bulk ms" << std::endl;
+
+    json a = target;
+    json b = target;
+    long long per_key = time_ms([&]()
+    {
+        for (const auto& member : source.object_range())
+        {
+            a.try_emplace(member.key(), member.value());
+        }
+    });
+    long long bulk = time_ms([&](){b.merge(source);});
+    report("merge", per_key, bulk);
+
+    a = target;
+    b = target;
+    per_key = time_ms([&]()
+    {
+        for (const auto& member : source.object_range())
+        {
+            a.insert_or_assign(member.key(), member.value());
+        }
+    });
+    bulk = time_ms([&](){b.merge_or_update(source);});
+    report("merge_or_update", per_key, bulk);
+
+    std::vector<std::string> keys;
+    for (size_t i = 0; i < n; i += 3)
+    {
+        keys.push_back("key" + std::to_string(i));
+    }
+    a = target;
+    b = target;
+    per_key = time_ms([&]()
+    {
+        for (const auto& key : keys)
+        {
+            a.erase(key);
+        }
+    });
+    bulk = time_ms([&](){b.erase_keys(keys.begin(), keys.end());});
+    report("erase a third of the keys", per_key, bulk);
+    std::cout << std::endl;
+}
+
+}
+
+int main()
+{
+    run(1000);
+    run(20000);
+}
@@ -0,0 +1,80 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures serializing many small messages to strings: through to_string,
+// an ostringstream, and a fixed buffer, and counting the characters of
+// a message.
+
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+template <class F>
+void run(const std::string& name, size_t n, F f)
+{
+    size_t length = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n; ++i)
+    {
+        length += f();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count()/static_cast<double>(n);
+
+    std::cout << std::left << std::setw(32) << name
+              << std::right
+              << std::setw(14) << std::fixed << std::setprecision(0) << ns
+              << std::setw(14) << length/n << std::endl;
+}
+
+}
+
+int main()
+{
+    const size_t n = 1000000;
+    json message = json::parse(R"({"id":1234567,"method":"get","params":{"key":"user:42","fields":["name","email"]}})");
+
+    std::cout << std::left << std::setw(32) << "small message"
+              << std::right
+              << std::setw(14) << "ns/message"
+              << std::setw(14) << "bytes" << std::endl;
+    run("to_string", n, [&]()
+    {
+        return message.to_string().length();
+    });
+    run("dump to std::string", n, [&]()
+    {
+        std::string s;
+        message.dump(s);
+        return s.length();
+    });
+    run("dump to std::ostringstream", n, [&]()
+    {
+        std::ostringstream os;
+        message.dump(os);
+        return os.str().length();
+    });
+    run("dump to fixed_buffer_sink", n, [&]()
+    {
+        char buffer[256];
+        fixed_buffer_sink sink(buffer, sizeof(buffer));
+        message.dump(sink);
+        return sink.size();
+    });
+    run("serialized_size", n, [&]()
+    {
+        return serialized_size(message);
+    });
+    run("serialized_size + exact dump", n, [&]()
+    {
+        std::vector<char> buffer(serialized_size(message));
+        return message.dump(buffer.data(), buffer.size());
+    });
+}
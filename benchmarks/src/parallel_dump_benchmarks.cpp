@@ -0,0 +1,86 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures parallel_dump against dump for a large array of records, with
+// one, two, four and all hardware threads.
+
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <jsoncons/json.hpp>
+#include <jsoncons/parallel_dump.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+json make_records(size_t n)
+{
+    json a = json::array();
+    a.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        json record;
+        record["id"] = static_cast<uint64_t>(i);
+        record["name"] = "customer " + std::to_string((i*7919) % 100000);
+        record["balance"] = (i % 1000) * 1.25;
+        record["tags"] = json::array{"alpha", "beta", static_cast<int64_t>(i % 7)};
+        a.push_back(std::move(record));
+    }
+    return a;
+}
+
+template <class F>
+void run(const std::string& name, F f)
+{
+    const size_t repeat = 3;
+    size_t length = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        std::string s;
+        f(s);
+        length += s.length();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+
+    std::cout << std::left << std::setw(32) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << length/repeat << std::endl;
+}
+
+}
+
+int main()
+{
+    json records = make_records(2000000);
+    serialization_options options;
+
+    std::cout << std::left << std::setw(32) << "2M records"
+              << std::right
+              << std::setw(12) << "ms"
+              << std::setw(14) << "bytes" << std::endl;
+    run("dump", [&](std::string& s)
+    {
+        records.dump(s);
+    });
+    std::vector<size_t> thread_counts = {1, 2, 4};
+    size_t hardware = std::thread::hardware_concurrency();
+    if (hardware > 4)
+    {
+        thread_counts.push_back(hardware);
+    }
+    for (size_t n : thread_counts)
+    {
+        run("parallel_dump, " + std::to_string(n) + " threads", [&](std::string& s)
+        {
+            string_sink sink(s);
+            parallel_dump(records, sink, options, false, n);
+        });
+    }
+}
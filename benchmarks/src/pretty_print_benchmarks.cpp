@@ -0,0 +1,101 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures the throughput of compact and pretty printed output, for a
+// document of shallow records and for a deeply nested one.
+
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+json make_records(size_t n)
+{
+    json a = json::array();
+    a.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        json record;
+        record["id"] = i;
+        record["name"] = "record " + std::to_string(i);
+        record["active"] = i % 3 == 0;
+        json tags = json::array();
+        tags.push_back("alpha");
+        tags.push_back("beta");
+        record["tags"] = std::move(tags);
+        json address;
+        address["city"] = "Toronto";
+        address["postal_code"] = "M5V 2T6";
+        record["address"] = std::move(address);
+        a.push_back(std::move(record));
+    }
+    return a;
+}
+
+json make_nested(size_t depth, size_t width)
+{
+    json j;
+    j["leaf"] = 1;
+    for (size_t d = 0; d < depth; ++d)
+    {
+        json level;
+        for (size_t w = 0; w < width; ++w)
+        {
+            level["k" + std::to_string(w)] = j;
+        }
+        j = std::move(level);
+    }
+    return j;
+}
+
+void run(const std::string& name, const json& j, const serialization_options& options, bool pprint)
+{
+    const size_t repeat = 5;
+    size_t length = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        std::string s;
+        string_sink sink(s);
+        json_serializer serializer(sink, options, pprint);
+        j.dump(serializer);
+        length += s.length();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+    double mb_per_s = ms > 0 ? (length/repeat)/(ms*1000.0) : 0;
+
+    std::cout << std::left << std::setw(40) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << length/repeat
+              << std::setw(10) << std::setprecision(0) << mb_per_s << std::endl;
+}
+
+}
+
+int main()
+{
+    json records = make_records(200000);
+    json nested = make_nested(12, 3);
+
+    serialization_options options;
+    serialization_options indent2;
+    indent2.indent(2);
+
+    std::cout << std::left << std::setw(40) << ""
+              << std::right
+              << std::setw(12) << "dump ms"
+              << std::setw(14) << "bytes"
+              << std::setw(10) << "MB/s" << std::endl;
+    run("200K records, compact", records, options, false);
+    run("200K records, pretty", records, options, true);
+    run("200K records, pretty, indent 2", records, indent2, true);
+    run("nested 12 deep, compact", nested, options, false);
+    run("nested 12 deep, pretty", nested, options, true);
+}
@@ -0,0 +1,113 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures writing and reading many small messages, with a new serializer or
+// parser for each message, and with one that is reset between messages.
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/json_decoder.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+const size_t n = 1000000;
+
+template <class F>
+void run(const std::string& name, F f)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    size_t length = f();
+    auto end = std::chrono::high_resolution_clock::now();
+    double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end-start).count()/static_cast<double>(n);
+
+    std::cout << std::left << std::setw(40) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ns
+              << std::setw(14) << length << std::endl;
+}
+
+}
+
+int main()
+{
+    json message = json::parse(R"({"id":12345,"price":101.25,"side":"buy","tags":["a","b"]})");
+    const std::string text = message.to_string();
+
+    std::cout << std::left << std::setw(40) << "1M small messages"
+              << std::right
+              << std::setw(12) << "ns/message"
+              << std::setw(14) << "chars" << std::endl;
+
+    run("write, new serializer", [&]()
+    {
+        size_t length = 0;
+        std::string s;
+        for (size_t i = 0; i < n; ++i)
+        {
+            s.clear();
+            string_sink sink(s);
+            json_serializer serializer(sink);
+            message.dump(serializer);
+            length += s.length();
+        }
+        return length;
+    });
+
+    run("write, serializer reset", [&]()
+    {
+        size_t length = 0;
+        std::string s;
+        string_sink first(s);
+        json_serializer serializer(first);
+        for (size_t i = 0; i < n; ++i)
+        {
+            s.clear();
+            string_sink sink(s);
+            serializer.reset(sink);
+            message.dump(serializer);
+            length += s.length();
+        }
+        return length;
+    });
+
+    run("read, new parser and decoder", [&]()
+    {
+        size_t length = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            json_decoder<json> decoder;
+            json_parser parser(decoder);
+            parser.set_source(text.data(), text.length());
+            parser.parse();
+            parser.end_parse();
+            parser.check_done();
+            length += decoder.get_result().size();
+        }
+        return length;
+    });
+
+    run("read, parser and decoder reset", [&]()
+    {
+        size_t length = 0;
+        json_decoder<json> decoder;
+        json_parser parser(decoder);
+        for (size_t i = 0; i < n; ++i)
+        {
+            parser.reset();
+            decoder.reset();
+            parser.set_source(text.data(), text.length());
+            parser.parse();
+            parser.end_parse();
+            parser.check_done();
+            length += decoder.get_result().size();
+        }
+        return length;
+    });
+}
@@ -0,0 +1,106 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Parses arrays of strings with different length distributions into
+// values with a small string capacity of 14, 22 and 30 bytes, and reports
+// the heap bytes, allocations and parse time of each.
+
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+#include <jsoncons/counting_allocator.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+template <size_t Capacity>
+struct small_string_policy : public sorted_policy
+{
+    static const size_t small_string_capacity = Capacity;
+};
+
+template <size_t Capacity>
+using json_with_capacity = basic_json<char,small_string_policy<Capacity>,counting_allocator<char,small_string_policy<Capacity>>>;
+
+struct corpus
+{
+    std::string name;
+    std::string text;
+    size_t values;
+};
+
+// Strings with lengths spread evenly over [min_length,max_length]
+corpus make_strings(size_t n, size_t min_length, size_t max_length)
+{
+    corpus c;
+    c.name = "strings of " + std::to_string(min_length) + " to " + std::to_string(max_length) + " chars";
+    c.values = n;
+
+    c.text.push_back('[');
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i > 0)
+        {
+            c.text.push_back(',');
+        }
+        c.text.push_back('\"');
+        c.text.append(min_length + (i*7919) % (max_length - min_length + 1), char('a' + i % 26));
+        c.text.push_back('\"');
+    }
+    c.text.push_back(']');
+    return c;
+}
+
+template <size_t Capacity>
+void measure(const corpus& c)
+{
+    typedef json_with_capacity<Capacity> Json;
+
+    allocation_statistics& stats = counting_allocator<char,small_string_policy<Capacity>>::statistics();
+    stats.reset();
+    auto start = std::chrono::high_resolution_clock::now();
+    Json j = Json::parse(c.text);
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << std::left << std::setw(36) << c.name
+              << std::right
+              << std::setw(10) << Capacity
+              << std::setw(10) << sizeof(Json)
+              << std::setw(14) << stats.live_bytes()
+              << std::setw(12) << std::fixed << std::setprecision(1) << double(stats.live_bytes())/c.values
+              << std::setw(12) << stats.allocations()
+              << std::setw(10) << std::chrono::duration_cast<std::chrono::milliseconds>(end-start).count()
+              << std::endl;
+}
+
+void run(const corpus& c)
+{
+    measure<14>(c);
+    measure<22>(c);
+    measure<30>(c);
+}
+
+}
+
+int main()
+{
+    const size_t n = 1000000;
+
+    std::cout << std::left << std::setw(36) << "corpus"
+              << std::right
+              << std::setw(10) << "capacity"
+              << std::setw(10) << "sizeof"
+              << std::setw(14) << "heap bytes"
+              << std::setw(12) << "per value"
+              << std::setw(12) << "allocs"
+              << std::setw(10) << "parse ms" << std::endl;
+
+    run(make_strings(n,1,8));
+    run(make_strings(n,8,16));
+    run(make_strings(n,12,24));
+    run(make_strings(n,16,32));
+    run(make_strings(n,32,64));
+}
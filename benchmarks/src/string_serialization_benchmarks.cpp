@@ -0,0 +1,87 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+// Measures serializing string-heavy documents: plain ASCII text, text with
+// occasional escapes, and text with non-ASCII characters.
+
+#include <string>
+#include <sstream>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <jsoncons/json.hpp>
+
+using namespace jsoncons;
+
+namespace {
+
+const char* words[] = {"alpha", "beta", "gamma", "delta", "epsilon", "zeta", "eta", "theta",
+                       "iota", "kappa", "lambda", "mu", "nu", "xi", "omicron", "pi"};
+
+json make_strings(size_t n, const std::string& extra, size_t every)
+{
+    json a = json::array();
+    a.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        std::string s;
+        size_t count = 2 + (i*7919) % 12;
+        for (size_t k = 0; k < count; ++k)
+        {
+            if (k > 0)
+            {
+                s.push_back(' ');
+            }
+            s += words[(i + k*31) % 16];
+            if (every != 0 && (i + k) % every == 0)
+            {
+                s += extra;
+            }
+        }
+        a.push_back(s);
+    }
+    return a;
+}
+
+void run(const std::string& name, const json& j, const serialization_options& options)
+{
+    const size_t repeat = 5;
+    size_t length = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < repeat; ++i)
+    {
+        std::ostringstream os;
+        j.dump(os, options);
+        length += os.str().length();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double ms = std::chrono::duration_cast<std::chrono::microseconds>(end-start).count()/1000.0/repeat;
+
+    std::cout << std::left << std::setw(40) << name
+              << std::right
+              << std::setw(12) << std::fixed << std::setprecision(1) << ms
+              << std::setw(14) << length/repeat << std::endl;
+}
+
+}
+
+int main()
+{
+    const size_t n = 1000000;
+    json plain = make_strings(n, "", 0);
+    json escapes = make_strings(n, "\\\"quoted\"\n", 10);
+    json utf8 = make_strings(n, "\xC3\xA9t\xC3\xA9", 3);
+
+    serialization_options options;
+    serialization_options ascii;
+    ascii.escape_all_non_ascii(true);
+
+    std::cout << std::left << std::setw(40) << "1M strings"
+              << std::right
+              << std::setw(12) << "dump ms"
+              << std::setw(14) << "bytes" << std::endl;
+    run("plain ASCII", plain, options);
+    run("escapes in 1 of 10 words", escapes, options);
+    run("UTF-8 in 1 of 3 words", utf8, options);
+    run("UTF-8, escape_all_non_ascii", utf8, ascii);
+}
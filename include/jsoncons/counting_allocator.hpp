@@ -0,0 +1,183 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_COUNTING_ALLOCATOR_HPP
+#define JSONCONS_COUNTING_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/detail/type_traits_helper.hpp>
+
+namespace jsoncons {
+
+// allocation_statistics
+
+// Counts of the allocations and deallocations made through counting_allocator.
+// Counters are updated atomically, so values may be freed on another thread.
+
+class allocation_statistics
+{
+public:
+    allocation_statistics()
+        : allocations_(0), deallocations_(0), bytes_allocated_(0), bytes_deallocated_(0), peak_bytes_(0)
+    {
+    }
+
+    allocation_statistics(const allocation_statistics&) = delete;
+    allocation_statistics& operator=(const allocation_statistics&) = delete;
+
+    size_t allocations() const
+    {
+        return allocations_.load(std::memory_order_relaxed);
+    }
+
+    size_t deallocations() const
+    {
+        return deallocations_.load(std::memory_order_relaxed);
+    }
+
+    size_t bytes_allocated() const
+    {
+        return bytes_allocated_.load(std::memory_order_relaxed);
+    }
+
+    size_t bytes_deallocated() const
+    {
+        return bytes_deallocated_.load(std::memory_order_relaxed);
+    }
+
+    size_t live_bytes() const
+    {
+        return bytes_allocated() - bytes_deallocated();
+    }
+
+    // Largest value of live_bytes since construction or the last reset
+    size_t peak_bytes() const
+    {
+        return peak_bytes_.load(std::memory_order_relaxed);
+    }
+
+    void reset()
+    {
+        allocations_.store(0,std::memory_order_relaxed);
+        deallocations_.store(0,std::memory_order_relaxed);
+        bytes_allocated_.store(0,std::memory_order_relaxed);
+        bytes_deallocated_.store(0,std::memory_order_relaxed);
+        peak_bytes_.store(0,std::memory_order_relaxed);
+    }
+
+    void record_allocation(size_t n)
+    {
+        allocations_.fetch_add(1,std::memory_order_relaxed);
+        size_t allocated = bytes_allocated_.fetch_add(n,std::memory_order_relaxed) + n;
+        size_t live = allocated - bytes_deallocated_.load(std::memory_order_relaxed);
+        size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+        while (live > peak && !peak_bytes_.compare_exchange_weak(peak,live,std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void record_deallocation(size_t n)
+    {
+        deallocations_.fetch_add(1,std::memory_order_relaxed);
+        bytes_deallocated_.fetch_add(n,std::memory_order_relaxed);
+    }
+private:
+    std::atomic<size_t> allocations_;
+    std::atomic<size_t> deallocations_;
+    std::atomic<size_t> bytes_allocated_;
+    std::atomic<size_t> bytes_deallocated_;
+    std::atomic<size_t> peak_bytes_;
+};
+
+namespace detail {
+
+template <class Tag>
+struct counting_allocator_statistics
+{
+    static allocation_statistics& get()
+    {
+        static allocation_statistics stats;
+        return stats;
+    }
+};
+
+}
+
+// counting_allocator
+
+// Allocates through Allocator and records each allocation in the statistics
+// shared by all counting allocators with the same Tag, whatever their value
+// type. It is stateless, so it can be used as the Allocator of basic_json
+// and the statistics cover every value parsed or built with that type.
+// Allocator must be stateless too.
+
+template <class T, class Tag = void, class Allocator = std::allocator<T>>
+class counting_allocator
+{
+    static_assert(is_stateless<Allocator>::value, "counting_allocator requires a stateless allocator");
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef counting_allocator<U,Tag,typename std::allocator_traits<Allocator>:: template rebind_alloc<U>> other;
+    };
+
+    counting_allocator() JSONCONS_NOEXCEPT
+    {
+    }
+
+    template <class U, class OtherAllocator>
+    counting_allocator(const counting_allocator<U,Tag,OtherAllocator>&) JSONCONS_NOEXCEPT
+    {
+    }
+
+    static allocation_statistics& statistics()
+    {
+        return detail::counting_allocator_statistics<Tag>::get();
+    }
+
+    T* allocate(size_type n)
+    {
+        Allocator alloc;
+        T* p = std::allocator_traits<Allocator>::allocate(alloc, n);
+        statistics().record_allocation(n*sizeof(T));
+        return p;
+    }
+
+    void deallocate(T* p, size_type n)
+    {
+        Allocator alloc;
+        std::allocator_traits<Allocator>::deallocate(alloc, p, n);
+        statistics().record_deallocation(n*sizeof(T));
+    }
+};
+
+template <class T, class U, class Tag, class Allocator1, class Allocator2>
+bool operator==(const counting_allocator<T,Tag,Allocator1>&, const counting_allocator<U,Tag,Allocator2>&)
+{
+    return true;
+}
+
+template <class T, class U, class Tag, class Allocator1, class Allocator2>
+bool operator!=(const counting_allocator<T,Tag,Allocator1>&, const counting_allocator<U,Tag,Allocator2>&)
+{
+    return false;
+}
+
+}
+
+#endif
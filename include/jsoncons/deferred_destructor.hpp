@@ -0,0 +1,108 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DEFERRED_DESTRUCTOR_HPP
+#define JSONCONS_DEFERRED_DESTRUCTOR_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <jsoncons/json.hpp>
+
+namespace jsoncons {
+
+// basic_deferred_destructor
+
+// Takes ownership of json values and destroys them on a background thread,
+// so that the thread giving up a large document does not wait for it to be
+// freed. The allocator of the values must allow deallocation from another
+// thread. The destructor frees any values still pending before returning.
+
+template <class Json>
+class basic_deferred_destructor
+{
+public:
+    typedef Json value_type;
+
+    basic_deferred_destructor()
+        : done_(false), busy_(false), worker_(&basic_deferred_destructor::run, this)
+    {
+    }
+
+    basic_deferred_destructor(const basic_deferred_destructor&) = delete;
+    basic_deferred_destructor& operator=(const basic_deferred_destructor&) = delete;
+
+    ~basic_deferred_destructor()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_ = true;
+        }
+        pending_cv_.notify_one();
+        worker_.join();
+    }
+
+    // Moves val out, leaving it null. Arrays and objects are queued for
+    // the background thread, other values are destroyed immediately.
+    void destroy(Json&& val)
+    {
+        Json temp(std::move(val));
+        val = Json(null_type());
+        if (temp.is_array() || (temp.is_object() && temp.size() > 0))
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                pending_.push_back(std::move(temp));
+            }
+            pending_cv_.notify_one();
+        }
+    }
+
+    // Blocks until every value queued so far has been destroyed
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_cv_.wait(lock, [this](){return pending_.empty() && !busy_;});
+    }
+private:
+    std::mutex mutex_;
+    std::condition_variable pending_cv_;
+    std::condition_variable idle_cv_;
+    std::vector<Json> pending_;
+    bool done_;
+    bool busy_;
+    std::thread worker_;
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true)
+        {
+            pending_cv_.wait(lock, [this](){return done_ || !pending_.empty();});
+            if (pending_.empty())
+            {
+                break;
+            }
+            std::vector<Json> batch;
+            batch.swap(pending_);
+            busy_ = true;
+            lock.unlock();
+            batch.clear();
+            lock.lock();
+            busy_ = false;
+            idle_cv_.notify_all();
+        }
+    }
+};
+
+typedef basic_deferred_destructor<json> deferred_destructor;
+typedef basic_deferred_destructor<wjson> wdeferred_destructor;
+
+}
+
+#endif
@@ -0,0 +1,79 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_ESCAPE_SCAN_HPP
+#define JSONCONS_DETAIL_ESCAPE_SCAN_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#if defined(JSONCONS_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+
+namespace jsoncons { namespace detail {
+
+// True if ch may need escaping in a JSON string: a quotation mark, reverse
+// solidus or control character, a solidus if escape_solidus, and a non-ASCII
+// character if escape_all_non_ascii. Everything else is copied as is.
+template <class CharT>
+bool is_escape_candidate(CharT ch, bool escape_solidus, bool escape_all_non_ascii)
+{
+    const uint32_t c = static_cast<typename std::make_unsigned<CharT>::type>(ch);
+    return c == '\"' || c == '\\' || c <= 0x1F || c == 0x7F
+        || (escape_solidus && c == '/')
+        || (escape_all_non_ascii && c >= 0x80);
+}
+
+// Returns the first character in [first,last) that may need escaping, or last
+template <class CharT>
+const CharT* find_escape_candidate(const CharT* first, const CharT* last,
+                                   bool escape_solidus, bool escape_all_non_ascii)
+{
+    while (first != last && !is_escape_candidate(*first, escape_solidus, escape_all_non_ascii))
+    {
+        ++first;
+    }
+    return first;
+}
+
+#if defined(JSONCONS_HAS_SSE2)
+
+// Tests sixteen bytes at a time, then finds the position in the block that
+// has a candidate one byte at a time
+inline const char* find_escape_candidate(const char* first, const char* last,
+                                         bool escape_solidus, bool escape_all_non_ascii)
+{
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i reverse_solidus = _mm_set1_epi8('\\');
+    const __m128i del = _mm_set1_epi8(0x7F);
+    const __m128i max_control = _mm_set1_epi8(0x1F);
+    // When not escaped, the solidus test repeats the quotation mark test
+    const __m128i solidus = _mm_set1_epi8(escape_solidus ? '/' : '\"');
+    const __m128i high_bit = _mm_set1_epi8(escape_all_non_ascii ? static_cast<char>(0x80) : 0);
+
+    while (last - first >= 16)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, reverse_solidus));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, del));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_min_epu8(v, max_control), v));
+        m = _mm_or_si128(m, _mm_cmpeq_epi8(v, solidus));
+        m = _mm_or_si128(m, _mm_and_si128(v, high_bit));
+        if (_mm_movemask_epi8(m) != 0)
+        {
+            break;
+        }
+        first += 16;
+    }
+    return find_escape_candidate<char>(first, last, escape_solidus, escape_all_non_ascii);
+}
+
+#endif
+
+}}
+
+#endif
@@ -0,0 +1,297 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_GRISU2_HPP
+#define JSONCONS_DETAIL_GRISU2_HPP
+
+#include <cstdint>
+#include <cstring>
+
+namespace jsoncons { namespace detail {
+
+// Grisu2, from Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+// Accurately with Integers", PLDI 2010. Produces digits that read back to
+// the same double, almost always the fewest such digits.
+
+struct diy_fp
+{
+    uint64_t f;
+    int e;
+
+    diy_fp(uint64_t f, int e)
+        : f(f), e(e)
+    {
+    }
+
+    static diy_fp sub(const diy_fp& x, const diy_fp& y)
+    {
+        return diy_fp(x.f - y.f, x.e);
+    }
+
+    // The upper 64 bits of the 128 bit product, rounded
+    static diy_fp mul(const diy_fp& x, const diy_fp& y)
+    {
+        const uint64_t u_lo = x.f & 0xFFFFFFFFu;
+        const uint64_t u_hi = x.f >> 32;
+        const uint64_t v_lo = y.f & 0xFFFFFFFFu;
+        const uint64_t v_hi = y.f >> 32;
+
+        const uint64_t p0 = u_lo * v_lo;
+        const uint64_t p1 = u_lo * v_hi;
+        const uint64_t p2 = u_hi * v_lo;
+        const uint64_t p3 = u_hi * v_hi;
+
+        uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+        q += uint64_t(1) << 31;
+
+        return diy_fp(p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32), x.e + y.e + 64);
+    }
+
+    static diy_fp normalize(diy_fp x)
+    {
+        while ((x.f >> 63) == 0)
+        {
+            x.f <<= 1;
+            --x.e;
+        }
+        return x;
+    }
+
+    static diy_fp normalize_to(const diy_fp& x, int e)
+    {
+        return diy_fp(x.f << (x.e - e), e);
+    }
+};
+
+// Powers of ten 10^k, k = -300, -292, ..., 324, as normalized diy_fp values
+// rounded to nearest, the kCachedPowers table of the reference Grisu2
+
+struct cached_power
+{
+    uint64_t f;
+    int e;
+    int k;
+};
+
+const int cached_powers_min_decimal_exponent = -300;
+const int cached_powers_decimal_exponent_step = 8;
+
+inline const cached_power& cached_power_at(int index)
+{
+    static const cached_power powers[] = 
+    {
+    { 0xAB70FE17C79AC6CA, -1060, -300 },
+    { 0xFF77B1FCBEBCDC4F, -1034, -292 },
+    { 0xBE5691EF416BD60C, -1007, -284 },
+    { 0x8DD01FAD907FFC3C,  -980, -276 },
+    { 0xD3515C2831559A83,  -954, -268 },
+    { 0x9D71AC8FADA6C9B5,  -927, -260 },
+    { 0xEA9C227723EE8BCB,  -901, -252 },
+    { 0xAECC49914078536D,  -874, -244 },
+    { 0x823C12795DB6CE57,  -847, -236 },
+    { 0xC21094364DFB5637,  -821, -228 },
+    { 0x9096EA6F3848984F,  -794, -220 },
+    { 0xD77485CB25823AC7,  -768, -212 },
+    { 0xA086CFCD97BF97F4,  -741, -204 },
+    { 0xEF340A98172AACE5,  -715, -196 },
+    { 0xB23867FB2A35B28E,  -688, -188 },
+    { 0x84C8D4DFD2C63F3B,  -661, -180 },
+    { 0xC5DD44271AD3CDBA,  -635, -172 },
+    { 0x936B9FCEBB25C996,  -608, -164 },
+    { 0xDBAC6C247D62A584,  -582, -156 },
+    { 0xA3AB66580D5FDAF6,  -555, -148 },
+    { 0xF3E2F893DEC3F126,  -529, -140 },
+    { 0xB5B5ADA8AAFF80B8,  -502, -132 },
+    { 0x87625F056C7C4A8B,  -475, -124 },
+    { 0xC9BCFF6034C13053,  -449, -116 },
+    { 0x964E858C91BA2655,  -422, -108 },
+    { 0xDFF9772470297EBD,  -396, -100 },
+    { 0xA6DFBD9FB8E5B88F,  -369,  -92 },
+    { 0xF8A95FCF88747D94,  -343,  -84 },
+    { 0xB94470938FA89BCF,  -316,  -76 },
+    { 0x8A08F0F8BF0F156B,  -289,  -68 },
+    { 0xCDB02555653131B6,  -263,  -60 },
+    { 0x993FE2C6D07B7FAC,  -236,  -52 },
+    { 0xE45C10C42A2B3B06,  -210,  -44 },
+    { 0xAA242499697392D3,  -183,  -36 },
+    { 0xFD87B5F28300CA0E,  -157,  -28 },
+    { 0xBCE5086492111AEB,  -130,  -20 },
+    { 0x8CBCCC096F5088CC,  -103,  -12 },
+    { 0xD1B71758E219652C,   -77,   -4 },
+    { 0x9C40000000000000,   -50,    4 },
+    { 0xE8D4A51000000000,   -24,   12 },
+    { 0xAD78EBC5AC620000,     3,   20 },
+    { 0x813F3978F8940984,    30,   28 },
+    { 0xC097CE7BC90715B3,    56,   36 },
+    { 0x8F7E32CE7BEA5C70,    83,   44 },
+    { 0xD5D238A4ABE98068,   109,   52 },
+    { 0x9F4F2726179A2245,   136,   60 },
+    { 0xED63A231D4C4FB27,   162,   68 },
+    { 0xB0DE65388CC8ADA8,   189,   76 },
+    { 0x83C7088E1AAB65DB,   216,   84 },
+    { 0xC45D1DF942711D9A,   242,   92 },
+    { 0x924D692CA61BE758,   269,  100 },
+    { 0xDA01EE641A708DEA,   295,  108 },
+    { 0xA26DA3999AEF774A,   322,  116 },
+    { 0xF209787BB47D6B85,   348,  124 },
+    { 0xB454E4A179DD1877,   375,  132 },
+    { 0x865B86925B9BC5C2,   402,  140 },
+    { 0xC83553C5C8965D3D,   428,  148 },
+    { 0x952AB45CFA97A0B3,   455,  156 },
+    { 0xDE469FBD99A05FE3,   481,  164 },
+    { 0xA59BC234DB398C25,   508,  172 },
+    { 0xF6C69A72A3989F5C,   534,  180 },
+    { 0xB7DCBF5354E9BECE,   561,  188 },
+    { 0x88FCF317F22241E2,   588,  196 },
+    { 0xCC20CE9BD35C78A5,   614,  204 },
+    { 0x98165AF37B2153DF,   641,  212 },
+    { 0xE2A0B5DC971F303A,   667,  220 },
+    { 0xA8D9D1535CE3B396,   694,  228 },
+    { 0xFB9B7CD9A4A7443C,   720,  236 },
+    { 0xBB764C4CA7A44410,   747,  244 },
+    { 0x8BAB8EEFB6409C1A,   774,  252 },
+    { 0xD01FEF10A657842C,   800,  260 },
+    { 0x9B10A4E5E9913129,   827,  268 },
+    { 0xE7109BFBA19C0C9D,   853,  276 },
+    { 0xAC2820D9623BF429,   880,  284 },
+    { 0x80444B5E7AA7CF85,   907,  292 },
+    { 0xBF21E44003ACDD2D,   933,  300 },
+    { 0x8E679C2F5E44FF8F,   960,  308 },
+    { 0xD433179D9C8CB841,   986,  316 },
+    { 0x9E19DB92B4E31BA9,  1013,  324 }
+    };
+    return powers[index];
+}
+
+// The binary exponents of the scaled boundaries are kept in [alpha,gamma]
+// so that the integral part fits in 32 bits
+const int grisu_alpha = -60;
+const int grisu_gamma = -32;
+
+inline cached_power get_cached_power_for_binary_exponent(int e)
+{
+    // k = ceil((alpha - e - 1) * log10(2))
+    const int f = grisu_alpha - e - 1;
+    const int k = (f * 78913) / (1 << 18) + static_cast<int>(f > 0);
+    const int index = (-cached_powers_min_decimal_exponent + k + (cached_powers_decimal_exponent_step - 1)) / cached_powers_decimal_exponent_step;
+    return cached_power_at(index);
+}
+
+// Returns the number of decimal digits of n, and the largest power of ten
+// not greater than n in pow10
+inline int find_largest_pow10(uint32_t n, uint32_t& pow10)
+{
+    static const uint32_t powers[] = {1,10,100,1000,10000,100000,1000000,10000000,100000000,1000000000};
+    int k = 10;
+    while (k > 1 && n < powers[k-1])
+    {
+        --k;
+    }
+    pow10 = powers[k-1];
+    return k;
+}
+
+inline void grisu2_round(char* buffer, int length, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
+{
+    while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+    {
+        --buffer[length - 1];
+        rest += ten_k;
+    }
+}
+
+inline void grisu2_digit_gen(char* buffer, int& length, int& decimal_exponent,
+                             diy_fp m_minus, diy_fp w, diy_fp m_plus)
+{
+    uint64_t delta = diy_fp::sub(m_plus,m_minus).f;
+    uint64_t dist = diy_fp::sub(m_plus,w).f;
+
+    const diy_fp one(uint64_t(1) << -m_plus.e, m_plus.e);
+
+    uint32_t p1 = static_cast<uint32_t>(m_plus.f >> -one.e);
+    uint64_t p2 = m_plus.f & (one.f - 1);
+
+    uint32_t pow10;
+    int n = find_largest_pow10(p1,pow10);
+    while (n > 0)
+    {
+        const uint32_t d = p1 / pow10;
+        p1 = p1 % pow10;
+        buffer[length++] = static_cast<char>('0' + d);
+        --n;
+        const uint64_t rest = (uint64_t(p1) << -one.e) + p2;
+        if (rest <= delta)
+        {
+            decimal_exponent += n;
+            grisu2_round(buffer,length,dist,delta,rest,uint64_t(pow10) << -one.e);
+            return;
+        }
+        pow10 /= 10;
+    }
+
+    int m = 0;
+    for (;;)
+    {
+        p2 *= 10;
+        const uint64_t d = p2 >> -one.e;
+        p2 &= one.f - 1;
+        buffer[length++] = static_cast<char>('0' + d);
+        ++m;
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta)
+        {
+            break;
+        }
+    }
+    decimal_exponent -= m;
+    grisu2_round(buffer,length,dist,delta,p2,one.f);
+}
+
+// Writes the digits of v, which must be finite and positive, to buffer
+// (at least 17 chars). The value is buffer[0,length) * 10^decimal_exponent.
+inline void grisu2(double v, char* buffer, int& length, int& decimal_exponent)
+{
+    const int bias = 1075;
+    const uint64_t hidden_bit = uint64_t(1) << 52;
+
+    uint64_t bits;
+    std::memcpy(&bits,&v,sizeof(bits));
+    const uint64_t biased_e = bits >> 52;
+    const uint64_t fraction = bits & (hidden_bit - 1);
+
+    const diy_fp x = biased_e == 0
+        ? diy_fp(fraction, 1 - bias)
+        : diy_fp(fraction + hidden_bit, static_cast<int>(biased_e) - bias);
+
+    // The boundaries are halfway to the neighbouring doubles, the lower one is
+    // closer when v is a power of two
+    const bool lower_boundary_is_closer = fraction == 0 && biased_e > 1;
+    const diy_fp m_plus = diy_fp::normalize(diy_fp(2*x.f + 1, x.e - 1));
+    const diy_fp m_minus = diy_fp::normalize_to(lower_boundary_is_closer
+                                                    ? diy_fp(4*x.f - 1, x.e - 2)
+                                                    : diy_fp(2*x.f - 1, x.e - 1), m_plus.e);
+    const diy_fp w = diy_fp::normalize(x);
+
+    const cached_power cached = get_cached_power_for_binary_exponent(m_plus.e);
+    const diy_fp c(cached.f,cached.e);
+
+    const diy_fp scaled_w = diy_fp::mul(w,c);
+    const diy_fp scaled_minus = diy_fp::mul(m_minus,c);
+    const diy_fp scaled_plus = diy_fp::mul(m_plus,c);
+
+    // Shrink the interval by one unit on each side for the rounding errors
+    length = 0;
+    decimal_exponent = -cached.k;
+    grisu2_digit_gen(buffer, length, decimal_exponent,
+                     diy_fp(scaled_minus.f + 1, scaled_minus.e),
+                     scaled_w,
+                     diy_fp(scaled_plus.f - 1, scaled_plus.e));
+}
+
+}}
+
+#endif
@@ -57,6 +57,11 @@ namespace jsoncons
 
 //#define JSONCONS_HAS_STRING_VIEW
 
+// Define JSONCONS_NO_SSE2 to scan strings one character at a time
+#if !defined(JSONCONS_NO_SSE2) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define JSONCONS_HAS_SSE2
+#endif
+
 #if defined(ANDROID) || defined(__ANDROID__)
 #define JSONCONS_HAS_STRTOLD_L
 #endif
@@ -80,7 +85,6 @@ namespace jsoncons
 #endif
 
 #if defined(_MSC_VER)
-#define JSONCONS_HAS__ECVT_S
 #define JSONCONS_HAS_FOPEN_S
 #define JSONCONS_HAS_WCSTOMBS_S
 #if _MSC_VER >= 1900
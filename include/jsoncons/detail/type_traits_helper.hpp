@@ -28,6 +28,8 @@
 #include <initializer_list>
 #include <jsoncons/detail/jsoncons_config.hpp>
 #include <jsoncons/detail/obufferedstream.hpp>
+#include <jsoncons/detail/grisu2.hpp>
+#include <jsoncons/output_sink.hpp>
 
 #if defined(JSONCONS_HAS_STRING_VIEW)
 #include <string_view>
@@ -737,57 +739,113 @@ inline std::basic_string<CharT, Traits, Alloc> view_to_string(const basic_string
     return std::basic_string<CharT, Traits, Alloc>(str.data(), str.size(), alloc);
 }
 
+// buffered_output
+
+// Writes characters into a buffer obtained from a basic_output_sink, and
+// gives the sink the characters written when the buffer is full or on flush.
+
 template <class CharT>
 class buffered_output
 {
-    static const size_t default_buffer_length = 16384;
-
-    std::basic_ostream<CharT>& os_;
-    std::vector<CharT> buffer_;
-    CharT * const begin_buffer_;
-    const CharT* const end_buffer_;
+    std::unique_ptr<basic_ostream_sink<CharT>> stream_sink_;
+    basic_output_sink<CharT>* sink_;
+    bool references_allowed_;
+    size_t min_reference_length_;
+    CharT* begin_buffer_;
+    CharT* end_buffer_;
     CharT* p_;
 
-
     // Noncopyable and nonmoveable
     buffered_output(const buffered_output&) = delete;
     buffered_output& operator=(const buffered_output&) = delete;
 
 public:
     buffered_output(std::basic_ostream<CharT>& os)
-        : os_(os), buffer_(default_buffer_length), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+default_buffer_length), p_(buffer_.data())
+        : stream_sink_(new basic_ostream_sink<CharT>(os)), sink_(stream_sink_.get()), references_allowed_(false), min_reference_length_(0),
+          begin_buffer_(nullptr), end_buffer_(nullptr), p_(nullptr)
     {
     }
     buffered_output(std::basic_ostream<CharT>& os, size_t buflen)
-        : os_(os), buffer_(buflen), begin_buffer_(buffer_.data()), end_buffer_(buffer_.data()+buflen), p_(buffer_.data())
+        : stream_sink_(new basic_ostream_sink<CharT>(os,buflen)), sink_(stream_sink_.get()), references_allowed_(false), min_reference_length_(0),
+          begin_buffer_(nullptr), end_buffer_(nullptr), p_(nullptr)
+    {
+    }
+    explicit buffered_output(basic_output_sink<CharT>& sink)
+        : sink_(std::addressof(sink)), references_allowed_(false), min_reference_length_(0), begin_buffer_(nullptr), end_buffer_(nullptr), p_(nullptr)
     {
     }
     ~buffered_output()
     {
-        os_.write(begin_buffer_, (p_ - begin_buffer_));
-        os_.flush();
+        try
+        {
+            flush_buffered();
+        }
+        catch (...)
+        {
+        }
     }
 
     void flush()
     {
-        os_.write(begin_buffer_, (p_ - begin_buffer_));
-        p_ = begin_buffer_;
-        os_.flush();
+        sink_->flush(p_ - begin_buffer_);
+        begin_buffer_ = end_buffer_ = p_ = nullptr;
     }
 
-    void write(const CharT* s, size_t length)
+    // Flushes anything buffered, and writes to os from now on, reusing the
+    // buffer of a stream that was written to before. After a flush, the
+    // previous stream or sink is not used again.
+    void reset(std::basic_ostream<CharT>& os)
     {
-        size_t diff = end_buffer_ - p_;
-        if (diff >= length)
+        flush_buffered();
+        if (stream_sink_)
         {
-            std::memcpy(p_, s, length*sizeof(CharT));
-            p_ += length;
+            stream_sink_->reset(os);
         }
         else
         {
-            os_.write(begin_buffer_, (p_ - begin_buffer_));
-            os_.write(s, length);
-            p_ = begin_buffer_;
+            stream_sink_.reset(new basic_ostream_sink<CharT>(os));
+        }
+        sink_ = stream_sink_.get();
+        min_reference_length_ = 0;
+    }
+
+    // Flushes anything buffered, and writes to sink from now on
+    void reset(basic_output_sink<CharT>& sink)
+    {
+        flush_buffered();
+        sink_ = std::addressof(sink);
+        min_reference_length_ = references_allowed_ ? sink.min_reference_length() : 0;
+    }
+
+    // Whether write_stable may pass runs to a sink that takes references.
+    // Off until allowed, because the caller must keep the characters
+    // unchanged until the next flush
+    void allow_references(bool value)
+    {
+        references_allowed_ = value;
+        min_reference_length_ = value ? sink_->min_reference_length() : 0;
+    }
+
+    // Drops the characters written since the sink last took any. Characters
+    // the sink has already taken are not recalled.
+    void discard()
+    {
+        p_ = begin_buffer_;
+    }
+
+    void write(const CharT* s, size_t length)
+    {
+        while (length > 0)
+        {
+            if (p_ == end_buffer_)
+            {
+                next_buffer(1);
+            }
+            const size_t n = (std::min)(length, static_cast<size_t>(end_buffer_ - p_));
+            std::memcpy(p_, s, n*sizeof(CharT));
+            p_ += n;
+            s += n;
+            length -= n;
         }
     }
 
@@ -796,25 +854,72 @@ public:
         write(s.data(),s.length());
     }
 
-    void put(CharT ch)
+    // Writes characters that stay unchanged until the next flush, which a
+    // sink may take by reference instead of by copy if references are allowed
+    void write_stable(const CharT* s, size_t length)
     {
-        if (p_ < end_buffer_)
+        if (min_reference_length_ != 0 && length >= min_reference_length_ &&
+            sink_->write_reference(p_ - begin_buffer_, s, length))
         {
-            *p_++ = ch;
+            begin_buffer_ = end_buffer_ = p_ = nullptr;
         }
         else
         {
-            os_.write(begin_buffer_, (p_-begin_buffer_));
-            p_ = begin_buffer_;
-            *p_++ = ch;
+            write(s, length);
+        }
+    }
+
+    void put(CharT ch)
+    {
+        if (p_ == end_buffer_)
+        {
+            next_buffer(1);
+        }
+        *p_++ = ch;
+    }
+
+    // Returns space for length characters, which are output by a following
+    // advance(length)
+    CharT* reserve(size_t length)
+    {
+        if (static_cast<size_t>(end_buffer_ - p_) < length)
+        {
+            next_buffer(length);
+        }
+        return p_;
+    }
+
+    void advance(size_t length)
+    {
+        p_ += length;
+    }
+private:
+    void flush_buffered()
+    {
+        if (begin_buffer_ != nullptr)
+        {
+            flush();
         }
     }
 
+    void next_buffer(size_t min_length)
+    {
+        size_t length = 0;
+        begin_buffer_ = sink_->next_buffer(p_ - begin_buffer_, min_length, length);
+        end_buffer_ = begin_buffer_ + length;
+        p_ = begin_buffer_;
+    }
 };
 
 // print_double
 
-#ifdef JSONCONS_HAS__ECVT_S
+// Writes a double with the given number of significant digits, as printf
+// %g would, with trailing zeros removed and at least one digit after the
+// decimal point. For normal values with 15 or fewer digits, when the
+// shortest digits from grisu2 fit, those digits are the %g result: decimals
+// of that length are further apart than two doubles, so the one that reads
+// back to val is also the one nearest to it. Otherwise the digits come from
+// snprintf %e, read without regard to the locale's decimal point.
 
 template <class CharT>
 class print_double
@@ -828,187 +933,151 @@ public:
 
     void operator()(double val, uint8_t precision, buffered_output<CharT>& os) 
     {
-        char buf[_CVTBUFSIZE];
-        int decimal_point = 0;
-        int sign = 0;
-
         int prec = (precision_ == 0) ? precision : precision_;
+        if (prec == 0)
+        {
+            prec = 1;
+        }
 
-        int err = _ecvt_s(buf, _CVTBUFSIZE, val, prec, &decimal_point, &sign);
-        if (err != 0)
+        if ((std::signbit)(val))
         {
-            throw std::runtime_error("Failed attempting double to string conversion");
+            os.put('-');
+            val = -val;
+        }
+        if (val == 0)
+        {
+            os.put('0');
+            os.put('.');
+            os.put('0');
+            return;
         }
-        //std::cout << "prec:" << prec << ", buf:" << buf << std::endl;
-        char* s = buf;
-        char* se = s + prec;
 
-        int i, k;
-        int j;
+        char buffer[max_precision + 32];
+        int length = 0;
+        int exponent = 0;
 
-        if (sign)
+        int decimal_exponent = 0;
+        if (prec <= std::numeric_limits<double>::digits10 && val >= (std::numeric_limits<double>::min)())
         {
-            os.put('-');
+            detail::grisu2(val, buffer, length, decimal_exponent);
+        }
+        if (length > 0 && length <= prec)
+        {
+            exponent = length - 1 + decimal_exponent;
+        }
+        else
+        {
+            format_digits(val, prec, buffer, length, exponent);
+        }
+        while (length > 1 && buffer[length-1] == '0')
+        {
+            --length;
+        }
+        write(buffer, length, exponent, prec, os);
+    }
+private:
+    static const int max_precision = 255;
+
+    // Digits and exponent of val rounded to prec significant digits
+    static void format_digits(double val, int prec, char* digits, int& length, int& exponent)
+    {
+        char buffer[max_precision + 32];
+        int n = c99_snprintf(buffer, sizeof(buffer), "%.*e", prec - 1, val);
+        if (n <= 0 || n >= static_cast<int>(sizeof(buffer)))
+        {
+            throw std::runtime_error("Failed attempting double to string conversion");
         }
-        if (decimal_point <= -4 || decimal_point > se - s + 5) 
+        const char* p = buffer;
+        const char* end = buffer + n;
+        length = 0;
+        // The decimal point depends on the C locale, skip whatever it is
+        for (; p != end && *p != 'e' && *p != 'E'; ++p)
         {
-            os.put(*s++);
-            if (s < se) 
+            if (*p >= '0' && *p <= '9')
             {
-                os.put('.');
-                while ((se-1) > s && *(se-1) == '0')
-                {
-                    --se;
-                }
+                digits[length++] = *p;
+            }
+        }
+        exponent = p != end ? std::atoi(p + 1) : 0;
+    }
 
-                while(s < se)
+    static void write(const char* digits, int length, int exponent, int prec, buffered_output<CharT>& os)
+    {
+        if (exponent < -4 || exponent >= prec)
+        {
+            os.put(digits[0]);
+            os.put('.');
+            if (length > 1)
+            {
+                for (int i = 1; i < length; ++i)
                 {
-                    os.put(*s++);
+                    os.put(digits[i]);
                 }
             }
+            else
+            {
+                os.put('0');
+            }
             os.put('e');
-            /* sprintf(b, "%+.2d", decimal_point - 1); */
-            if (--decimal_point < 0) {
+            if (exponent < 0)
+            {
                 os.put('-');
-                decimal_point = -decimal_point;
-                }
+                exponent = -exponent;
+            }
             else
-                os.put('+');
-            for(j = 2, k = 10; 10*k <= decimal_point; j++, k *= 10);
-            for(;;) 
             {
-                i = decimal_point / k;
-                os.put(static_cast<CharT>(i) + '0');
-                if (--j <= 0)
-                    break;
-                decimal_point -= i*k;
-                decimal_point *= 10;
+                os.put('+');
             }
-        }
-        else if (decimal_point <= 0) 
-        {
-            os.put('0');
-            os.put('.');
-            while ((se-1) > s && *(se-1) == '0')
+            char buf[8];
+            int n = 0;
+            do
             {
-                --se;
-            }
-            for(; decimal_point < 0; decimal_point++)
+                buf[n++] = static_cast<char>('0' + exponent % 10);
+                exponent /= 10;
+            } while (exponent != 0);
+            if (n < 2)
             {
-                os.put('0');
+                buf[n++] = '0';
             }
-            while(s < se)
+            while (n > 0)
             {
-                os.put(*s++);
+                os.put(buf[--n]);
             }
         }
-        else {
-            while(s < se) 
+        else if (exponent < 0)
+        {
+            os.put('0');
+            os.put('.');
+            for (int i = exponent + 1; i < 0; ++i)
             {
-                os.put(*s++);
-                if ((--decimal_point == 0) && s < se)
-                {
-                    os.put('.');
-                    while ((se-1) > s && *(se-1) == '0')
-                    {
-                        --se;
-                    }
-                }
+                os.put('0');
             }
-            for(; decimal_point > 0; decimal_point--)
+            for (int i = 0; i < length; ++i)
             {
-                os.put('0');
+                os.put(digits[i]);
             }
         }
-    }
-};
-
-#else
-
-template <class CharT>
-class print_double
-{
-    uint8_t precision_;
-    basic_obufferedstream<CharT> oss_;
-public:
-    print_double(uint8_t precision)
-        : precision_(precision)
-    {
-        oss_.imbue(std::locale::classic());
-        oss_.precision(precision);
-    }
-    void operator()(double val, uint8_t precision, buffered_output<CharT>& os)
-    {
-        oss_.clear_sequence();
-        oss_.precision((precision_ == 0) ? precision : precision_);
-        oss_ << val;
-
-        //std::cout << "precision_:" << (int)precision_ << ", precision:" << (int)precision << ", buf:" << oss_.data() << std::endl;
-
-        const CharT* sbeg = oss_.data();
-        const CharT* send = sbeg + oss_.length();
-        const CharT* pexp = send;
-
-        if (sbeg != send)
+        else
         {
-            bool dot = false;
-            for (pexp = sbeg; *pexp != 'e' && *pexp != 'E' && pexp < send; ++pexp)
+            for (int i = 0; i <= exponent; ++i)
             {
+                os.put(i < length ? digits[i] : '0');
             }
-
-            if (pexp != send)
+            os.put('.');
+            if (length > exponent + 1)
             {
-                const CharT* p = pexp;
-                while (p >= sbeg+2 && *(p-1) == '0' && *(p-2) != '.')
-                {
-                    --p;
-                }
-                for (const CharT* q = sbeg; q < p; ++q)
-                {
-                    if (*q == '.')
-                    {
-                        dot = true;
-                    }
-                    os.put(*q);
-                }
-                if (!dot)
-                {
-                    os.put('.');
-                    os.put('0');
-                    dot = true;
-                }
-                for (const CharT* q = pexp; q < send; ++q)
+                for (int i = exponent + 1; i < length; ++i)
                 {
-                    os.put(*q);
+                    os.put(digits[i]);
                 }
             }
             else
             {
-                const CharT* p = send;
-                while (p >= sbeg+2 && *(p-1) == '0' && *(p-2) != '.')
-                {
-                    --p;
-                }
-                const CharT* qend = *(p-2) == '.' ? p : send;
-                for (const CharT* q = sbeg; q < qend; ++q)
-                {
-                    if (*q == '.')
-                    {
-                        dot = true;
-                    }
-                    os.put(*q);
-                }
-            }
-
-            if (!dot)
-            {
-                os.put('.');
                 os.put('0');
             }
         }
     }
 };
-#endif
 
 #if defined(_MSC_VER)
 
@@ -17,10 +17,12 @@
 #include <memory>
 #include <typeinfo>
 #include <cstring>
+#include <unordered_set>
 #include <jsoncons/version.hpp>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
 #include <jsoncons/json_structures.hpp>
+#include <jsoncons/small_vector.hpp>
 #include <jsoncons/json_output_handler.hpp>
 #include <jsoncons/serialization_options.hpp>
 #include <jsoncons/json_serializer.hpp>
@@ -40,6 +42,23 @@ struct sorted_policy
 {
     static const bool preserve_order = false;
 
+    // Arrays of int64, uint64 or double values read by the decoder are
+    // kept in packed form, see json_array::pack
+    static const bool pack_numeric_arrays = false;
+
+    // Copies of a value share its arrays and objects, which are cloned on
+    // the first non-const access while shared
+    static const bool copy_on_write = false;
+
+    // Bytes a value holds for a string of up to small_string_capacity - 1
+    // chars (bytes) before allocating. With the type tag and the length
+    // they make up the value, 16 bytes by default, 24 with 22 and 32 with 30
+    static const size_t small_string_capacity = 14;
+
+    // Objects with at most this many members are searched by key equality
+    // rather than binary search. 0 searches sorted objects by binary search
+    static const size_t linear_search_threshold = 0;
+
     template <class T,class Allocator>
     using object_storage = std::vector<T,Allocator>;
 
@@ -60,6 +79,25 @@ struct preserve_order_policy : public sorted_policy
     static const bool preserve_order = true;
 };
 
+// Arrays and objects keep up to four elements in the container itself,
+// so a small array or object costs one allocation rather than two
+
+struct small_storage_policy : public sorted_policy
+{
+    static const size_t linear_search_threshold = 8;
+
+    template <class T,class Allocator>
+    using object_storage = small_vector<T,4,Allocator>;
+
+    template <class T,class Allocator>
+    using array_storage = small_vector<T,4,Allocator>;
+};
+
+struct preserve_order_small_storage_policy : public small_storage_policy
+{
+    static const bool preserve_order = true;
+};
+
 template <typename IteratorT>
 class range 
 {
@@ -82,21 +120,6 @@ public:
     }
 };
 
-enum class json_type_tag : uint8_t 
-{
-    null_t = 0,
-    empty_object_t,
-    bool_t,
-    integer_t,
-    uinteger_t,
-    double_t,
-    small_string_t,
-    string_t,
-    byte_string_t,
-    array_t,
-    object_t
-};
-                        
 template <class CharT, 
           class ImplementationPolicy = sorted_policy, 
           class Allocator = std::allocator<CharT>>
@@ -148,14 +171,15 @@ public:
 
     using object_storage_type = typename implementation_policy::template object_storage<key_value_pair_type , kvp_allocator_type>;
     typedef json_object<key_storage_type,basic_json,implementation_policy::preserve_order> object;
+    typedef basic_object_builder<basic_json> object_builder;
 
     typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<array> array_allocator;
     typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<object> object_allocator;
 
-    typedef typename object::iterator object_iterator;
-    typedef typename object::const_iterator const_object_iterator;
-    typedef typename array::iterator array_iterator;
-    typedef typename array::const_iterator const_array_iterator;
+    typedef typename detail::container_iterators<object_storage_type>::iterator object_iterator;
+    typedef typename detail::container_iterators<object_storage_type>::const_iterator const_object_iterator;
+    typedef typename detail::container_iterators<array_storage_type>::iterator array_iterator;
+    typedef json_array_const_iterator<basic_json,typename detail::container_iterators<array_storage_type>::const_iterator,packed_numeric_array<allocator_type>> const_array_iterator;
 
     struct variant
     {
@@ -279,11 +303,12 @@ public:
 
         class small_string_data : public base_data
         {
-            static const size_t capacity = 14/sizeof(char_type);
+            static const size_t capacity = small_string_capacity_of<implementation_policy>::value/sizeof(char_type);
+            static_assert(capacity >= 2 && capacity <= 256, "small_string_capacity must allow for 1 to 255 chars and a terminator");
             uint8_t length_;
             char_type data_[capacity];
         public:
-            static const size_t max_length = (14 / sizeof(char_type)) - 1;
+            static const size_t max_length = capacity - 1;
 
             small_string_data(const char_type* p, uint8_t length)
                 : base_data(json_type_tag::small_string_t), length_(length)
@@ -394,6 +419,11 @@ public:
                 return ptr_->length();
             }
 
+            size_t heap_bytes() const
+            {
+                return sizeof(string_storage_type) + detail::heap_capacity_bytes(*ptr_,1);
+            }
+
             allocator_type get_allocator() const
             {
                 return ptr_->get_allocator();
@@ -473,6 +503,11 @@ public:
                 return ptr_->size();
             }
 
+            size_t heap_bytes() const
+            {
+                return sizeof(byte_string_storage_type) + detail::heap_capacity_bytes(*ptr_);
+            }
+
             allocator_type get_allocator() const
             {
                 return ptr_->get_allocator();
@@ -501,12 +536,24 @@ public:
                 }
             }
         public:
+            explicit array_data(const Allocator& a)
+                : base_data(json_type_tag::array_t)
+            {
+                create(array_allocator(a),a);
+            }
+
             array_data(const array& val)
                 : base_data(json_type_tag::array_t)
             {
                 create(val.get_allocator(), val);
             }
 
+            array_data(array&& val)
+                : base_data(json_type_tag::array_t)
+            {
+                create(val.get_allocator(), std::move(val));
+            }
+
             array_data(const array& val, const Allocator& a)
                 : base_data(json_type_tag::array_t)
             {
@@ -516,7 +563,15 @@ public:
             array_data(const array_data& val)
                 : base_data(json_type_tag::array_t)
             {
-                create(val.ptr_->get_allocator(), *(val.ptr_));
+                if (is_copy_on_write_policy<implementation_policy>::value)
+                {
+                    ptr_ = val.ptr_;
+                    ptr_->add_ref();
+                }
+                else
+                {
+                    create(val.ptr_->get_allocator(), *(val.ptr_));
+                }
             }
 
             array_data(array_data&& val)
@@ -534,9 +589,7 @@ public:
             {
                 if (ptr_ != nullptr)
                 {
-                    typename std::allocator_traits<array_allocator>:: template rebind_alloc<array> alloc(ptr_->get_allocator());
-                    std::allocator_traits<array_allocator>:: template rebind_traits<array>::destroy(alloc, to_plain_pointer(ptr_));
-                    alloc.deallocate(ptr_,1);
+                    release(ptr_);
                 }
             }
 
@@ -550,8 +603,19 @@ public:
                 std::swap(val.ptr_,ptr_);
             }
 
+            bool is_shared() const
+            {
+                return ptr_->is_shared();
+            }
+
             array& value()
             {
+                if (ptr_->is_shared())
+                {
+                    pointer ptr = ptr_;
+                    create(ptr->get_allocator(), *ptr);
+                    release(ptr);
+                }
                 return *ptr_;
             }
 
@@ -559,6 +623,17 @@ public:
             {
                 return *ptr_;
             }
+        private:
+            static void release(pointer ptr)
+            {
+                if (ptr->release())
+                {
+                    Destroy_structures_(*ptr);
+                    typename std::allocator_traits<array_allocator>:: template rebind_alloc<array> alloc(ptr->get_allocator());
+                    std::allocator_traits<array_allocator>:: template rebind_traits<array>::destroy(alloc, to_plain_pointer(ptr));
+                    alloc.deallocate(ptr,1);
+                }
+            }
         };
 
         // object_data
@@ -595,6 +670,12 @@ public:
                 create(val.get_allocator(), val);
             }
 
+            explicit object_data(object&& val)
+                : base_data(json_type_tag::object_t)
+            {
+                create(val.get_allocator(), std::move(val));
+            }
+
             explicit object_data(const object& val, const Allocator& a)
                 : base_data(json_type_tag::object_t)
             {
@@ -604,7 +685,15 @@ public:
             explicit object_data(const object_data& val)
                 : base_data(json_type_tag::object_t)
             {
-                create(val.ptr_->get_allocator(), *(val.ptr_));
+                if (is_copy_on_write_policy<implementation_policy>::value)
+                {
+                    ptr_ = val.ptr_;
+                    ptr_->add_ref();
+                }
+                else
+                {
+                    create(val.ptr_->get_allocator(), *(val.ptr_));
+                }
             }
 
             explicit object_data(object_data&& val)
@@ -623,9 +712,7 @@ public:
             {
                 if (ptr_ != nullptr)
                 {
-                    typename std::allocator_traits<Allocator>:: template rebind_alloc<object> alloc(ptr_->get_allocator());
-                    std::allocator_traits<Allocator>:: template rebind_traits<object>::destroy(alloc, to_plain_pointer(ptr_));
-                    alloc.deallocate(ptr_,1);
+                    release(ptr_);
                 }
             }
 
@@ -634,8 +721,19 @@ public:
                 std::swap(val.ptr_,ptr_);
             }
 
+            bool is_shared() const
+            {
+                return ptr_->is_shared();
+            }
+
             object& value()
             {
+                if (ptr_->is_shared())
+                {
+                    pointer ptr = ptr_;
+                    create(ptr->get_allocator(), *ptr);
+                    release(ptr);
+                }
                 return *ptr_;
             }
 
@@ -648,9 +746,24 @@ public:
             {
                 return ptr_->get_allocator();
             }
+        private:
+            static void release(pointer ptr)
+            {
+                if (ptr->release())
+                {
+                    Destroy_structures_(*ptr);
+                    typename std::allocator_traits<Allocator>:: template rebind_alloc<object> alloc(ptr->get_allocator());
+                    std::allocator_traits<Allocator>:: template rebind_traits<object>::destroy(alloc, to_plain_pointer(ptr));
+                    alloc.deallocate(ptr,1);
+                }
+            }
         };
 
     private:
+        // The type tag shares the first word with the small string length and
+        // the double precision, heap allocated alternatives hold a single pointer,
+        // so a value occupies two words (16 bytes on 64 bit platforms), unless
+        // the policy's small_string_capacity makes the small string larger
         static const size_t data_size = static_max<sizeof(uinteger_data),sizeof(double_data),sizeof(small_string_data), sizeof(string_data), sizeof(array_data), sizeof(object_data)>::value;
         static const size_t data_align = static_max<JSONCONS_ALIGNOF(uinteger_data),JSONCONS_ALIGNOF(double_data),JSONCONS_ALIGNOF(small_string_data),JSONCONS_ALIGNOF(string_data),JSONCONS_ALIGNOF(array_data),JSONCONS_ALIGNOF(object_data)>::value;
 
@@ -779,6 +892,10 @@ public:
         {
             new(reinterpret_cast<void*>(&data_))object_data(val);
         }
+        variant(object&& val)
+        {
+            new(reinterpret_cast<void*>(&data_))object_data(std::move(val));
+        }
         variant(const object& val, const Allocator& alloc)
         {
             new(reinterpret_cast<void*>(&data_))object_data(val, alloc);
@@ -787,6 +904,10 @@ public:
         {
             new(reinterpret_cast<void*>(&data_))array_data(val);
         }
+        variant(array&& val)
+        {
+            new(reinterpret_cast<void*>(&data_))array_data(std::move(val));
+        }
         variant(const array& val, const Allocator& alloc)
         {
             new(reinterpret_cast<void*>(&data_))array_data(val,alloc);
@@ -853,10 +974,8 @@ public:
                     new(reinterpret_cast<void*>(&data_))byte_string_data(*(val.byte_string_data_cast()));
                     break;
                 case json_type_tag::array_t:
-                    new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()));
-                    break;
                 case json_type_tag::object_t:
-                    new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()));
+                    Init_(val);
                     break;
                 default:
                     JSONCONS_UNREACHABLE();
@@ -1788,10 +1907,24 @@ public:
                 new(reinterpret_cast<void*>(&data_))byte_string_data(*(val.byte_string_data_cast()));
                 break;
             case json_type_tag::object_t:
-                new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()));
+                if (is_copy_on_write_policy<implementation_policy>::value)
+                {
+                    new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()));
+                }
+                else
+                {
+                    Init_structure_(val, val.object_data_cast()->get_allocator());
+                }
                 break;
             case json_type_tag::array_t:
-                new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()));
+                if (is_copy_on_write_policy<implementation_policy>::value)
+                {
+                    new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()));
+                }
+                else
+                {
+                    Init_structure_(val, val.array_data_cast()->get_allocator());
+                }
                 break;
             default:
                 break;
@@ -1818,16 +1951,166 @@ public:
                 new(reinterpret_cast<void*>(&data_))byte_string_data(*(val.byte_string_data_cast()),a);
                 break;
             case json_type_tag::array_t:
-                new(reinterpret_cast<void*>(&data_))array_data(*(val.array_data_cast()),a);
-                break;
             case json_type_tag::object_t:
-                new(reinterpret_cast<void*>(&data_))object_data(*(val.object_data_cast()),a);
+                Init_structure_(val, a);
                 break;
             default:
                 break;
             }
         }
 
+        // Deep copies of arrays and objects proceed one level at a time from
+        // an explicit work list. Nested arrays and objects are first copied as
+        // null, then filled in when their turn comes, so the depth of nesting
+        // does not determine the depth of recursion
+
+        typedef std::vector<std::pair<variant*,const variant*>> copy_work_list;
+
+        static bool is_structure_(const basic_json& val)
+        {
+            return val.var_.type_id() == json_type_tag::array_t || val.var_.type_id() == json_type_tag::object_t;
+        }
+
+        void Init_structure_(const variant& val, const Allocator& a)
+        {
+            new(reinterpret_cast<void*>(&data_))null_data();
+            copy_work_list work;
+            try
+            {
+                Init_level_(val, a, work);
+                while (!work.empty())
+                {
+                    auto item = work.back();
+                    work.pop_back();
+                    item.first->Init_level_(*(item.second), a, work);
+                }
+            }
+            catch (...)
+            {
+                Destroy_();
+                new(reinterpret_cast<void*>(&data_))null_data();
+                throw;
+            }
+        }
+
+        // The array or object is built in a local before it is moved into
+        // place, so if allocating it throws, this variant is left as it was
+        void Init_level_(const variant& val, const Allocator& a, copy_work_list& work)
+        {
+            size_t mark = work.size();
+            auto copy = [&a](const basic_json& element) -> basic_json
+            {
+                return is_structure_(element) ? basic_json(null_type()) : basic_json(element, a);
+            };
+
+            if (val.type_id() == json_type_tag::array_t)
+            {
+                const array& source = val.array_data_cast()->value();
+                array_data data(a);
+                new(reinterpret_cast<void*>(&data_))array_data(std::move(data));
+                array& target = array_data_cast()->value();
+                target.copy_elements_(source, copy);
+                if (!source.is_packed())
+                {
+                    auto it = target.begin();
+                    for (const auto& element : source)
+                    {
+                        if (is_structure_(element))
+                        {
+                            work.emplace_back(&(it->var_), &(element.var_));
+                        }
+                        ++it;
+                    }
+                }
+            }
+            else
+            {
+                const object& source = val.object_data_cast()->value();
+                object_data data(a);
+                new(reinterpret_cast<void*>(&data_))object_data(std::move(data));
+                object& target = object_data_cast()->value();
+                target.copy_members_(source, copy);
+                auto it = target.begin();
+                for (const auto& member : source)
+                {
+                    if (is_structure_(member.value()))
+                    {
+                        work.emplace_back(&(it->value().var_), &(member.value().var_));
+                    }
+                    ++it;
+                }
+            }
+            // Nested values are copied in document order, as recursion would
+            std::reverse(work.begin() + mark, work.end());
+        }
+
+        // A container being destroyed moves the arrays and objects it holds
+        // to an explicit stack, and each is taken apart in the same way before
+        // it is destroyed, so the depth of nesting does not determine the depth
+        // of recursion. The stack is allocated with the container's allocator.
+        // Destruction must not throw, so if the stack cannot grow, the values
+        // not yet taken apart are destroyed recursively instead
+
+        typedef std::vector<basic_json,typename std::allocator_traits<Allocator>:: template rebind_alloc<basic_json>> destroy_stack;
+
+        static void Move_structures_(array& val, destroy_stack& stack)
+        {
+            size_t mark = stack.size();
+            if (!val.is_packed())
+            {
+                for (auto& element : val)
+                {
+                    if (is_structure_(element))
+                    {
+                        stack.push_back(std::move(element));
+                    }
+                }
+            }
+            std::reverse(stack.begin() + mark, stack.end());
+        }
+
+        static void Move_structures_(object& val, destroy_stack& stack)
+        {
+            size_t mark = stack.size();
+            for (auto& member : val)
+            {
+                if (is_structure_(member.value()))
+                {
+                    stack.push_back(std::move(member.value()));
+                }
+            }
+            std::reverse(stack.begin() + mark, stack.end());
+        }
+
+        template <class Container>
+        static void Destroy_structures_(Container& val) JSONCONS_NOEXCEPT
+        {
+            try
+            {
+                destroy_stack stack(val.get_allocator());
+                Move_structures_(val, stack);
+                while (!stack.empty())
+                {
+                    basic_json current(std::move(stack.back()));
+                    stack.pop_back();
+                    if (current.var_.type_id() == json_type_tag::array_t)
+                    {
+                        if (!current.var_.array_data_cast()->is_shared())
+                        {
+                            Move_structures_(current.var_.array_data_cast()->value(), stack);
+                        }
+                    }
+                    else if (!current.var_.object_data_cast()->is_shared())
+                    {
+                        Move_structures_(current.var_.object_data_cast()->value(), stack);
+                    }
+                }
+            }
+            catch (...)
+            {
+            }
+        }
+
         void Init_rv_(variant&& val) JSONCONS_NOEXCEPT
         {
             switch (val.type_id())
@@ -1943,6 +2226,15 @@ public:
         }
     };
 
+    // json_proxy
+
+    // Refers to the member name of the value given by parent_. The name is
+    // held as a view, so a proxy must not outlive the string it was created
+    // from, and a proxy created from a temporary, as in j[std::string("a")],
+    // may be used only within the full expression that created it. The
+    // member is looked up on each access, and a copy of the name is made
+    // only when an assignment creates the member.
+
     template <class ParentT>
     class json_proxy 
     {
@@ -1950,33 +2242,34 @@ public:
         typedef json_proxy<ParentT> proxy_type;
 
         ParentT& parent_;
-        key_storage_type key_;
+        string_view_type key_;
 
         json_proxy() = delete;
         json_proxy& operator = (const json_proxy& other) = delete; 
 
-        json_proxy(ParentT& parent, key_storage_type&& name)
-            : parent_(parent), key_(std::forward<key_storage_type>(name))
+        json_proxy(ParentT& parent, const string_view_type& name)
+            : parent_(parent), key_(name)
         {
         }
 
         basic_json& evaluate() 
         {
-            return parent_.evaluate(string_view_type(key_.data(),key_.size()));
+            return parent_.evaluate(key_);
         }
 
         const basic_json& evaluate() const
         {
-            return parent_.evaluate(string_view_type(key_.data(),key_.size()));
+            return parent_.evaluate(key_);
         }
 
         basic_json& evaluate_with_default()
         {
             basic_json& val = parent_.evaluate_with_default();
-            auto it = val.find(string_view_type(key_.data(),key_.size()));
-            if (it == val.object_range().end())
+            object& o = val.object_value();
+            auto it = o.find(key_);
+            if (it == o.end())
             {
-                it = val.set_(val.object_range().begin(),std::move(key_),object(val.object_value().get_allocator()));            
+                it = val.try_emplace(key_,object(o.get_allocator())).first;            
             }
             return it->value();
         }
@@ -2197,7 +2490,7 @@ public:
         template <class T>
         json_proxy& operator=(T&& val) 
         {
-            parent_.evaluate_with_default().set_(std::move(key_), std::forward<T>(val));
+            parent_.evaluate_with_default().insert_or_assign(key_, basic_json(std::forward<T>(val)));
             return *this;
         }
 
@@ -2211,6 +2504,16 @@ public:
             return evaluate() != val;
         }
 
+        size_t hash_code() const
+        {
+            return evaluate().hash_code();
+        }
+
+        json_memory_footprint memory_footprint() const
+        {
+            return evaluate().memory_footprint();
+        }
+
         basic_json& operator[](size_t i)
         {
             return evaluate_with_default().at(i);
@@ -2223,7 +2526,7 @@ public:
 
         json_proxy<proxy_type> operator[](const string_view_type& name)
         {
-            return json_proxy<proxy_type>(*this,key_storage_type(name.begin(),name.end(),key_.get_allocator()));
+            return json_proxy<proxy_type>(*this,name);
         }
 
         const basic_json& operator[](const string_view_type& name) const
@@ -2306,6 +2609,12 @@ public:
             evaluate().erase(name);
         }
 
+        template <class InputIt>
+        void erase_keys(InputIt first, InputIt last)
+        {
+            evaluate().erase_keys(first, last);
+        }
+
         void erase(const_array_iterator pos)
         {
             evaluate().erase(pos);
@@ -2492,6 +2801,26 @@ public:
         {
             evaluate().dump(os,options,pprint);
         }
+
+        void dump(basic_output_sink<char_type>& sink) const
+        {
+            evaluate().dump(sink);
+        }
+
+        void dump(basic_output_sink<char_type>& sink, const basic_serialization_options<char_type>& options) const
+        {
+            evaluate().dump(sink,options);
+        }
+
+        size_t dump(char_type* data, size_t length) const
+        {
+            return evaluate().dump(data,length);
+        }
+
+        size_t dump(char_type* data, size_t length, const basic_serialization_options<char_type>& options) const
+        {
+            return evaluate().dump(data,length,options);
+        }
 #if !defined(JSONCONS_NO_DEPRECATED)
 
         string_type to_string(const char_allocator_type& allocator = char_allocator_type()) const JSONCONS_NOEXCEPT
@@ -2986,6 +3315,101 @@ public:
         return var_ == rhs.var_;
     }
 
+    // Values that compare equal have the same hash code
+    size_t hash_code() const
+    {
+        switch (var_.type_id())
+        {
+        case json_type_tag::null_t:
+            return detail::hash_seed(detail::json_hash_seed::null_value);
+        case json_type_tag::bool_t:
+            return detail::hash_combine(detail::hash_seed(detail::json_hash_seed::bool_value), var_.bool_data_cast()->value() ? 1 : 0);
+        case json_type_tag::integer_t:
+            return detail::hash_number(static_cast<double>(var_.integer_data_cast()->value()));
+        case json_type_tag::uinteger_t:
+            return detail::hash_number(static_cast<double>(var_.uinteger_data_cast()->value()));
+        case json_type_tag::double_t:
+            return detail::hash_number(var_.double_data_cast()->value());
+        case json_type_tag::small_string_t:
+        case json_type_tag::string_t:
+            {
+                string_view_type sv = as_string_view();
+                return detail::hash_combine(detail::hash_seed(detail::json_hash_seed::string_value), detail::hash_chars(sv.data(),sv.length()));
+            }
+        case json_type_tag::byte_string_t:
+            return detail::hash_combine(detail::hash_seed(detail::json_hash_seed::byte_string_value), 
+                                        detail::hash_chars(var_.byte_string_data_cast()->data(),var_.byte_string_data_cast()->length()));
+        case json_type_tag::empty_object_t:
+            return detail::hash_object(0,0);
+        case json_type_tag::object_t:
+            return var_.object_data_cast()->value().hash_code();
+        case json_type_tag::array_t:
+            return var_.array_data_cast()->value().hash_code();
+        default:
+            JSONCONS_UNREACHABLE();
+            break;
+        }
+    }
+
+    // Heap bytes held by this value and its descendants. Arrays and objects
+    // shared between copies under copy_on_write are counted once.
+    json_memory_footprint memory_footprint() const
+    {
+        json_memory_footprint footprint;
+        std::unordered_set<const void*> shared;
+        std::vector<const basic_json*> stack;
+        stack.push_back(this);
+        while (!stack.empty())
+        {
+            const basic_json* p = stack.back();
+            stack.pop_back();
+            switch (p->var_.type_id())
+            {
+            case json_type_tag::string_t:
+                footprint.string_bytes += p->var_.string_data_cast()->heap_bytes();
+                break;
+            case json_type_tag::byte_string_t:
+                footprint.string_bytes += p->var_.byte_string_data_cast()->heap_bytes();
+                break;
+            case json_type_tag::array_t:
+                {
+                    const array& a = p->var_.array_data_cast()->value();
+                    if (p->var_.array_data_cast()->is_shared() && !shared.insert(&a).second)
+                    {
+                        break;
+                    }
+                    footprint.array_bytes += sizeof(array) + a.heap_bytes();
+                    if (!a.is_packed())
+                    {
+                        for (const auto& element : a)
+                        {
+                            stack.push_back(&element);
+                        }
+                    }
+                }
+                break;
+            case json_type_tag::object_t:
+                {
+                    const object& o = p->var_.object_data_cast()->value();
+                    if (p->var_.object_data_cast()->is_shared() && !shared.insert(&o).second)
+                    {
+                        break;
+                    }
+                    footprint.object_bytes += sizeof(object) + o.heap_bytes();
+                    footprint.key_bytes += o.key_heap_bytes();
+                    for (const auto& member : o)
+                    {
+                        stack.push_back(&member.value());
+                    }
+                }
+                break;
+            default:
+                break;
+            }
+        }
+        return footprint;
+    }
+
     size_t size() const JSONCONS_NOEXCEPT
     {
         switch (var_.type_id())
@@ -3011,6 +3435,8 @@ public:
         return at(i);
     }
 
+    // The proxy holds name as a view, so it must not be kept beyond the 
+    // lifetime of the string name refers to
     json_proxy<basic_json> operator[](const string_view_type& name)
     {
         switch (var_.type_id())
@@ -3019,7 +3445,7 @@ public:
             create_object_implicitly();
             // FALLTHRU
         case json_type_tag::object_t:
-            return json_proxy<basic_json>(*this, key_storage_type(name.begin(),name.end(),char_allocator_type(object_value().get_allocator())));
+            return json_proxy<basic_json>(*this, name);
             break;
         default:
             JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
@@ -3035,26 +3461,24 @@ public:
     template <class SAllocator>
     void dump(std::basic_string<char_type,char_traits_type,SAllocator>& s) const
     {
-        std::basic_ostringstream<char_type,char_traits_type,SAllocator> os;
-        os.imbue(std::locale::classic());
+        s.clear();
+        basic_string_sink<char_type,char_traits_type,SAllocator> sink(s);
         {
-            basic_json_serializer<char_type> serializer(os);
+            basic_json_serializer<char_type> serializer(sink);
             dump(serializer);
         }
-        s = os.str();
     }
 
     template <class SAllocator>
     void dump(std::basic_string<char_type,char_traits_type,SAllocator>& s,
               const basic_serialization_options<char_type>& options) const
     {
-        std::basic_ostringstream<char_type,char_traits_type,SAllocator> os;
-        os.imbue(std::locale::classic());
+        s.clear();
+        basic_string_sink<char_type,char_traits_type,SAllocator> sink(s);
         {
-            basic_json_serializer<char_type> serializer(os,options);
+            basic_json_serializer<char_type> serializer(sink,options);
             dump(serializer);
         }
-        s = os.str();
     }
 
 #if !defined(JSONCONS_NO_DEPRECATED)
@@ -3109,9 +3533,16 @@ public:
             {
                 handler.begin_array();
                 const array& o = array_value();
-                for (const_array_iterator it = o.begin(); it != o.end(); ++it)
+                if (o.is_packed())
                 {
-                    it->dump_fragment(handler);
+                    o.packed().dump(handler);
+                }
+                else
+                {
+                    for (const_array_iterator it = o.begin(); it != o.end(); ++it)
+                    {
+                        it->dump_fragment(handler);
+                    }
                 }
                 handler.end_array();
             }
@@ -3151,29 +3582,62 @@ public:
         dump(serializer);
     }
 
+    // The value is not changed while it is written, so a sink may take its
+    // strings by reference
+    void dump(basic_output_sink<char_type>& sink) const
+    {
+        basic_json_serializer<char_type> serializer(sink);
+        serializer.stable_strings(true);
+        dump(serializer);
+    }
+
+    void dump(basic_output_sink<char_type>& sink, const basic_serialization_options<char_type>& options) const
+    {
+        basic_json_serializer<char_type> serializer(sink, options);
+        serializer.stable_strings(true);
+        dump(serializer);
+    }
+
+    // Writes to [data, data + length), which must hold all of the output,
+    // as it will if length is serialized_size(*this), and returns the
+    // number of characters written
+    size_t dump(char_type* data, size_t length) const
+    {
+        return dump(data, length, basic_serialization_options<char_type>());
+    }
+
+    size_t dump(char_type* data, size_t length, const basic_serialization_options<char_type>& options) const
+    {
+        basic_fixed_buffer_sink<char_type> sink(data, length);
+        dump(sink, options);
+        if (sink.overflow())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Output does not fit in the buffer");
+        }
+        return sink.size();
+    }
+
     string_type to_string(const char_allocator_type& allocator=char_allocator_type()) const JSONCONS_NOEXCEPT
     {
         string_type s(allocator);
-        std::basic_ostringstream<char_type,char_traits_type,char_allocator_type> os(s);
-        os.imbue(std::locale::classic());
+        basic_string_sink<char_type,char_traits_type,char_allocator_type> sink(s);
         {
-            basic_json_serializer<char_type> serializer(os);
+            basic_json_serializer<char_type> serializer(sink);
             dump_fragment(serializer);
         }
-        return os.str();
+        return s;
     }
 
     string_type to_string(const basic_serialization_options<char_type>& options,
                           const char_allocator_type& allocator=char_allocator_type()) const
     {
         string_type s(allocator);
-        std::basic_ostringstream<char_type> os(s);
-        os.imbue(std::locale::classic());
+        basic_string_sink<char_type,char_traits_type,char_allocator_type> sink(s);
         {
-            basic_json_serializer<char_type> serializer(os, options);
+            basic_json_serializer<char_type> serializer(sink, options);
             dump_fragment(serializer);
         }
-        return os.str();
+        return s;
     }
 
 #if !defined(JSONCONS_NO_DEPRECATED)
@@ -3239,7 +3703,7 @@ public:
         case json_type_tag::object_t:
             {
                 const_object_iterator it = object_value().find(name);
-                return it != object_range().end();
+                return it != object_value().end();
             }
             break;
         default:
@@ -3254,7 +3718,7 @@ public:
         case json_type_tag::object_t:
             {
                 auto it = object_value().find(name);
-                if (it == object_range().end())
+                if (it == object_value().end())
                 {
                     return 0;
                 }
@@ -3642,7 +4106,7 @@ public:
         case json_type_tag::object_t:
             {
                 auto it = object_value().find(name);
-                if (it == object_range().end())
+                if (it == object_value().end())
                 {
                     JSONCONS_THROW_EXCEPTION_1(std::out_of_range, "%s not found", view_to_string(name));
                 }
@@ -3689,7 +4153,7 @@ public:
         case json_type_tag::object_t:
             {
                 auto it = object_value().find(name);
-                if (it == object_range().end())
+                if (it == object_value().end())
                 {
                     JSONCONS_THROW_EXCEPTION_1(std::out_of_range, "%s not found", view_to_string(name));
                 }
@@ -3779,7 +4243,7 @@ public:
         case json_type_tag::object_t:
             {
                 const_object_iterator it = object_value().find(name);
-                if (it != object_range().end())
+                if (it != object_value().end())
                 {
                     return it->value();
                 }
@@ -3807,7 +4271,7 @@ public:
         case json_type_tag::object_t:
             {
                 const_object_iterator it = object_value().find(name);
-                if (it != object_range().end())
+                if (it != object_value().end())
                 {
                     return it->value().template as<T>();
                 }
@@ -3834,7 +4298,7 @@ public:
         case json_type_tag::object_t:
             {
                 const_object_iterator it = object_value().find(name);
-                if (it != object_range().end())
+                if (it != object_value().end())
                 {
                     return it->value().as_string_view();
                 }
@@ -3955,6 +4419,23 @@ public:
         }
     }
 
+    // Removes the members with the keys in [first,last)
+    template <class InputIt>
+    void erase_keys(InputIt first, InputIt last)
+    {
+        switch (var_.type_id())
+        {
+        case json_type_tag::empty_object_t:
+            break;
+        case json_type_tag::object_t:
+            object_value().erase_keys(first, last);
+            break;
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempting to erase keys on a value that is not an object");
+            break;
+        }
+    }
+
     template <class T>
     std::pair<object_iterator,bool> set(const string_view_type& name, T&& val)
     {
@@ -4502,7 +4983,7 @@ public:
         case json_type_tag::object_t:
             {
                 const_object_iterator it = object_value().find(name);
-                return it != object_range().end() ? it->value() : a_null;
+                return it != object_value().end() ? it->value() : a_null;
             }
         default:
             {
@@ -4606,7 +5087,7 @@ public:
         case json_type_tag::object_t:
             {
                 const_object_iterator it = object_value().find(name);
-                return it != object_range().end();
+                return it != object_value().end();
             }
             break;
         default:
@@ -4796,8 +5277,7 @@ public:
         switch (var_.type_id())
         {
         case json_type_tag::empty_object_t:
-            const_cast<basic_json*>(this)->create_object_implicitly(); // HERE
-            // FALLTHRU
+            return empty_object_value();
         case json_type_tag::object_t:
             return var_.object_data_cast()->value();
         default:
@@ -4808,6 +5288,25 @@ public:
 
 private:
 
+    // A shared empty object, so that const access does not modify the value
+    template <class A=allocator_type>
+    typename std::enable_if<std::is_default_constructible<A>::value,const object&>::type
+    empty_object_value() const
+    {
+        static const object an_empty_object = object();
+        return an_empty_object;
+    }
+
+    // Without a default allocator there is nothing to construct a shared
+    // empty object with, fall back to creating it in place
+    template <class A=allocator_type>
+    typename std::enable_if<!std::is_default_constructible<A>::value,const object&>::type
+    empty_object_value() const
+    {
+        const_cast<basic_json*>(this)->create_object_implicitly();
+        return var_.object_data_cast()->value();
+    }
+
     friend std::basic_ostream<char_type>& operator<<(std::basic_ostream<char_type>& os, const basic_json& o)
     {
         o.dump(os);
@@ -4936,6 +5435,23 @@ json_printable<Json> pretty_print(const Json& val,
     return json_printable<Json>(val, true, options);
 }
 
+// The number of characters that dump writes for val, counted by running
+// the serializer into a sink that discards its output
+template<class Json>
+size_t serialized_size(const Json& val,
+                       const basic_serialization_options<typename Json::char_type>& options)
+{
+    basic_counting_sink<typename Json::char_type> sink;
+    val.dump(sink, options);
+    return sink.count();
+}
+
+template<class Json>
+size_t serialized_size(const Json& val)
+{
+    return serialized_size(val, basic_serialization_options<typename Json::char_type>());
+}
+
 typedef basic_json<char,sorted_policy,std::allocator<char>> json;
 typedef basic_json<wchar_t,sorted_policy,std::allocator<wchar_t>> wjson;
 typedef basic_json<char, preserve_order_policy, std::allocator<char>> ojson;
@@ -4981,6 +5497,18 @@ jsoncons::wojson operator "" _ojson(const wchar_t* s, std::size_t n)
 
 }
 
+namespace std {
+
+template <class CharT,class ImplementationPolicy,class Allocator>
+struct hash<jsoncons::basic_json<CharT,ImplementationPolicy,Allocator>>
+{
+    size_t operator()(const jsoncons::basic_json<CharT,ImplementationPolicy,Allocator>& val) const
+    {
+        return val.hash_code();
+    }
+};
+
+}
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic pop
@@ -15,6 +15,7 @@
 #include <memory>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_structures.hpp>
 
 namespace jsoncons {
 
@@ -27,11 +28,15 @@ public:
 
     static const int default_stack_size = 1000;
 
+    // Shorter numeric arrays are not worth the extra allocations of packed form
+    static const size_t min_packed_array_length = 8;
+
     typedef typename Json::key_value_pair_type key_value_pair_type;
     typedef typename Json::key_storage_type key_storage_type;
     typedef typename Json::string_type string_type;
     typedef typename Json::array array;
     typedef typename Json::object object;
+    typedef typename Json::object_builder object_builder;
     typedef typename Json::allocator_type json_allocator_type;
     typedef typename string_type::allocator_type json_string_allocator;
     typedef typename array::allocator_type json_array_allocator;
@@ -78,6 +83,19 @@ public:
         return std::move(result_);
     }
 
+    // Discards any result and any partly built value, keeping the stack
+    void reset()
+    {
+        result_ = Json();
+        for (size_t i = 0; i < top_; ++i)
+        {
+            stack_[i].value_ = Json();
+        }
+        top_ = 0;
+        stack_offsets_.clear();
+        is_valid_ = false;
+    }
+
 #if !defined(JSONCONS_NO_DEPRECATED)
     Json& root()
     {
@@ -106,7 +124,8 @@ private:
     void push_object()
     {
         stack_offsets_.push_back(top_);
-        stack_[top_].value_ = object(object_allocator_);
+        // Marks the start of an object, the object itself is built by end_structure
+        stack_[top_].value_ = Json();
         if (++top_ >= stack_.size())
         {
             stack_.resize(top_*2);
@@ -178,10 +197,13 @@ private:
         auto last = first + count;
         if (stack_[stack_offsets_.back()].value_.is_object())
         {
-            stack_[structure_index].value_.object_value().insert(
-                std::make_move_iterator(first),
-                std::make_move_iterator(last),
-                [](stack_item&& val){return key_value_pair_type(std::move(val.name_),std::move(val.value_));});
+            object_builder builder(object_allocator_);
+            builder.reserve(count);
+            for (; first != last; ++first)
+            {
+                builder.push_back(key_value_pair_type(std::move(first->name_),std::move(first->value_)));
+            }
+            stack_[structure_index].value_ = builder.build();
         }
         else
         {
@@ -192,6 +214,10 @@ private:
                 j.push_back(std::move(first->value_));
                 ++first;
             }
+            if (is_packing_policy<typename Json::implementation_policy>::value && count >= min_packed_array_length)
+            {
+                j.array_value().pack();
+            }
         }
         top_ -= count;
     }
@@ -0,0 +1,191 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_INDEX_HPP
+#define JSONCONS_JSON_INDEX_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <jsoncons/json.hpp>
+
+namespace jsoncons {
+
+// basic_json_index
+
+// Index over the elements of an array by the value found at a path of
+// member names in each element, for example "id" or "address", "city".
+// Elements where the path does not lead to a value are not indexed.
+// Entries are kept sorted by the hash code of the value, and lookups
+// compare the candidates with operator==, so a lookup never returns an
+// element whose value does not match.
+//
+// The index refers to the array and does not see later changes to it.
+// is_current() reports false once the array has been accessed non-const,
+// after which json_query filters the array element by element until
+// rebuild() is called. invalidate() marks the index out of date explicitly.
+// Each rebuild and invalidation increments generation().
+
+template <class Json>
+class basic_json_index
+{
+public:
+    typedef Json value_type;
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+
+    basic_json_index(const Json& array, const string_view_type& name)
+        : array_(std::addressof(array)), size_(0), array_id_(0), modification_count_(0), generation_(0), valid_(false)
+    {
+        path_.push_back(string_type(name.data(),name.length()));
+        rebuild();
+    }
+
+    basic_json_index(const Json& array, std::vector<string_type> path)
+        : array_(std::addressof(array)), path_(std::move(path)), size_(0), array_id_(0), modification_count_(0), generation_(0), valid_(false)
+    {
+        if (path_.empty())
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"An index path must have at least one member name");
+        }
+        rebuild();
+    }
+
+    const Json& array() const
+    {
+        return *array_;
+    }
+
+    const std::vector<string_type>& path() const
+    {
+        return path_;
+    }
+
+    size_t generation() const
+    {
+        return generation_;
+    }
+
+    // True if the index has not been invalidated since it was built, and
+    // the value is still the same array object and has had no non-const
+    // access since. A change made through a reference or iterator obtained
+    // before the index was built is not detected.
+    bool is_current() const
+    {
+        return valid_ && array_->is_array() && array_->size() == size_ 
+            && array_->array_value().id() == array_id_
+            && array_->array_value().modification_count() == modification_count_;
+    }
+
+    void rebuild()
+    {
+        if (!array_->is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempting to index a value that is not an array");
+        }
+        entries_.clear();
+        size_ = array_->size();
+        entries_.reserve(size_);
+        for (size_t i = 0; i < size_; ++i)
+        {
+            const Json* val = field((*array_)[i]);
+            if (val != nullptr)
+            {
+                entries_.emplace_back(val->hash_code(),i);
+            }
+        }
+        std::sort(entries_.begin(),entries_.end());
+        array_id_ = array_->array_value().id();
+        modification_count_ = array_->array_value().modification_count();
+        valid_ = true;
+        ++generation_;
+    }
+
+    void invalidate()
+    {
+        valid_ = false;
+        ++generation_;
+    }
+
+    // Positions of the elements whose value at path equals val, in
+    // increasing order
+    std::vector<size_t> positions(const Json& val) const
+    {
+        std::vector<size_t> result;
+        auto range = std::equal_range(entries_.begin(),entries_.end(),entry_type(val.hash_code(),0),
+                                      [](const entry_type& a, const entry_type& b){return a.first < b.first;});
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second < array_->size())
+            {
+                const Json* candidate = field((*array_)[it->second]);
+                if (candidate != nullptr && *candidate == val)
+                {
+                    result.push_back(it->second);
+                }
+            }
+        }
+        return result;
+    }
+
+    // The elements whose value at path equals val, in array order
+    std::vector<const Json*> find(const Json& val) const
+    {
+        std::vector<const Json*> result;
+        for (size_t i : positions(val))
+        {
+            result.push_back(std::addressof((*array_)[i]));
+        }
+        return result;
+    }
+
+    size_t count(const Json& val) const
+    {
+        return positions(val).size();
+    }
+
+    // The value at path in element, or nullptr
+    const Json* field(const Json& element) const
+    {
+        const Json* p = std::addressof(element);
+        for (const auto& name : path_)
+        {
+            if (!p->is_object())
+            {
+                return nullptr;
+            }
+            auto it = p->find(string_view_type(name.data(),name.length()));
+            if (it == p->object_range().end())
+            {
+                return nullptr;
+            }
+            p = std::addressof(it->value());
+        }
+        return p;
+    }
+private:
+    typedef std::pair<size_t,size_t> entry_type;
+
+    const Json* array_;
+    std::vector<string_type> path_;
+    std::vector<entry_type> entries_;
+    size_t size_;
+    size_t array_id_;
+    size_t modification_count_;
+    size_t generation_;
+    bool valid_;
+};
+
+typedef basic_json_index<json> json_index;
+typedef basic_json_index<ojson> ojson_index;
+typedef basic_json_index<wjson> wjson_index;
+typedef basic_json_index<wojson> wojson_index;
+
+}
+
+#endif
@@ -16,40 +16,85 @@
 
 namespace jsoncons {
 
-template<class CharT> 
-void print_integer(int64_t value, buffered_output<CharT>& os)
+namespace detail {
+
+inline size_t count_decimal_digits(uint64_t value)
+{
+    size_t n = 1;
+    for (;;)
+    {
+        if (value < 10) return n;
+        if (value < 100) return n + 1;
+        if (value < 1000) return n + 2;
+        if (value < 10000) return n + 3;
+        value /= 10000u;
+        n += 4;
+    }
+}
+
+// Writes the decimal digits of value, two at a time, so that they end at last
+template <class CharT>
+void write_decimal_digits(uint64_t value, CharT* last)
 {
-    CharT buf[255];
-    uint64_t u = (value < 0) ? static_cast<uint64_t>(-value) : static_cast<uint64_t>(value);
-    CharT* p = buf;
-    do
+    static const char digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    while (value >= 100)
     {
-        *p++ = static_cast<CharT>(48 + u%10);
+        const size_t i = static_cast<size_t>(value % 100)*2;
+        value /= 100;
+        *--last = static_cast<CharT>(digit_pairs[i+1]);
+        *--last = static_cast<CharT>(digit_pairs[i]);
     }
-    while (u /= 10);
-    if (value < 0)
+    if (value >= 10)
     {
-        os.put('-');
+        const size_t i = static_cast<size_t>(value)*2;
+        *--last = static_cast<CharT>(digit_pairs[i+1]);
+        *--last = static_cast<CharT>(digit_pairs[i]);
     }
-    while (--p >= buf)
+    else
     {
-        os.put(*p);
+        *--last = static_cast<CharT>('0' + value);
     }
 }
 
+// Writes an optional minus sign and the digits of magnitude directly into
+// the output buffer
 template<class CharT>
-void print_uinteger(uint64_t value, buffered_output<CharT>& os)
+void print_decimal(bool negative, uint64_t magnitude, buffered_output<CharT>& os)
 {
-    CharT buf[255];
-    CharT* p = buf;
-    do
-    {
-        *p++ = static_cast<CharT>(48 + value % 10);
-    } while (value /= 10);
-    while (--p >= buf)
+    const size_t length = count_decimal_digits(magnitude) + (negative ? 1 : 0);
+    CharT* p = os.reserve(length);
+    if (negative)
     {
-        os.put(*p);
+        *p = '-';
     }
+    write_decimal_digits(magnitude, p + length);
+    os.advance(length);
+}
+
+}
+
+template<class CharT> 
+void print_integer(int64_t value, buffered_output<CharT>& os)
+{
+    const uint64_t u = (value < 0) ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    detail::print_decimal(value < 0, u, os);
+}
+
+template<class CharT>
+void print_uinteger(uint64_t value, buffered_output<CharT>& os)
+{
+    detail::print_decimal(false, value, os);
 }
 
 template <class CharT>
@@ -374,6 +374,9 @@ public:
         }
     }
 
+    // Returns the parser to the state it was constructed in, ready for
+    // another document, keeping its buffers, its input source and its
+    // locale. The input source is replaced with set_source.
     void reset()
     {
         state_stack_.clear();
@@ -383,6 +386,12 @@ public:
         line_ = 1;
         column_ = 1;
         nesting_depth_ = 0;
+        cp_ = 0;
+        cp2_ = 0;
+        is_negative_ = false;
+        precision_ = 0;
+        string_buffer_.clear();
+        number_buffer_.clear();
     }
 
     void check_done()
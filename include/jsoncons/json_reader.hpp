@@ -142,7 +142,7 @@ class basic_json_reader
     static const size_t default_max_buffer_length = 16384;
 
     basic_json_parser<CharT,Allocator> parser_;
-    std::basic_istream<CharT>& is_;
+    std::basic_istream<CharT>* is_;
     bool eof_;
     std::vector<CharT,Allocator> buffer_;
     size_t buffer_length_;
@@ -156,7 +156,7 @@ public:
 
     basic_json_reader(std::basic_istream<CharT>& is)
         : parser_(),
-          is_(is),
+          is_(std::addressof(is)),
           eof_(false),
           buffer_length_(default_max_buffer_length),
           begin_(true)
@@ -167,7 +167,7 @@ public:
     basic_json_reader(std::basic_istream<CharT>& is,
                       parse_error_handler& err_handler)
        : parser_(err_handler),
-         is_(is),
+         is_(std::addressof(is)),
          eof_(false),
          buffer_length_(default_max_buffer_length),
          begin_(true)
@@ -178,7 +178,7 @@ public:
     basic_json_reader(std::basic_istream<CharT>& is, 
                       basic_json_input_handler<CharT>& handler)
         : parser_(handler),
-          is_(is),
+          is_(std::addressof(is)),
           eof_(false),
           buffer_length_(default_max_buffer_length),
           begin_(true)
@@ -190,7 +190,7 @@ public:
                       basic_json_input_handler<CharT>& handler,
                       parse_error_handler& err_handler)
        : parser_(handler,err_handler),
-         is_(is),
+         is_(std::addressof(is)),
          eof_(false),
          buffer_length_(default_max_buffer_length),
          begin_(true)
@@ -198,6 +198,25 @@ public:
         buffer_.reserve(buffer_length_);
     }
 
+    // Discards what has been read, and begins reading the stream again from
+    // its current position, as a new reader would, keeping the buffer and
+    // the parser
+    void reset()
+    {
+        parser_.reset();
+        buffer_.clear();
+        parser_.set_source(buffer_.data(),0);
+        eof_ = false;
+        begin_ = true;
+    }
+
+    // Resets the reader to read from is
+    void reset(std::basic_istream<CharT>& is)
+    {
+        is_ = std::addressof(is);
+        reset();
+    }
+
     size_t buffer_length() const
     {
         return buffer_length_;
@@ -233,8 +252,8 @@ public:
     {
         buffer_.clear();
         buffer_.resize(buffer_length_);
-        is_.read(buffer_.data(), buffer_length_);
-        buffer_.resize(static_cast<size_t>(is_.gcount()));
+        is_->read(buffer_.data(), buffer_length_);
+        buffer_.resize(static_cast<size_t>(is_->gcount()));
         if (buffer_.size() == 0)
         {
             eof_ = true;
@@ -264,9 +283,9 @@ public:
         {
             if (parser_.source_exhausted())
             {
-                if (!is_.eof())
+                if (!is_->eof())
                 {
-                    if (is_.fail())
+                    if (is_->fail())
                     {
                         ec = json_parser_errc::source_error;
                         return;
@@ -325,9 +344,9 @@ public:
             {
                 if (parser_.source_exhausted())
                 {
-                    if (!is_.eof())
+                    if (!is_->eof())
                     {
-                        if (is_.fail())
+                        if (is_->fail())
                         {
                             ec = json_parser_errc::source_error;
                             return;
@@ -14,17 +14,26 @@
 #include <ostream>
 #include <cstdlib>
 #include <limits> // std::numeric_limits
+#include <algorithm>
 #include <fstream>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/output_sink.hpp>
 #include <jsoncons/serialization_options.hpp>
 #include <jsoncons/json_output_handler.hpp>
 
 namespace jsoncons {
 
+namespace detail {
+template <class Json>
+class parallel_serializer;
+}
+
 template<class CharT>
 class basic_json_serializer : public basic_json_output_handler<CharT>
 {
+    template <class Json>
+    friend class detail::parallel_serializer;
 public:
     using typename basic_json_output_handler<CharT>::string_view_type                                 ;
 
@@ -78,12 +87,24 @@ private:
         bool indent_once_;
         bool unindent_at_end_;
     };
+    // A member name and what is written for it: the name escaped and
+    // quoted, and the colon
+    struct key_cache_entry
+    {
+        std::basic_string<CharT> key;
+        std::basic_string<CharT> output;
+    };
+    static const size_t key_cache_size = 64;
+    static const size_t max_cached_key_length = 64;
+
     basic_serialization_options<CharT> options_;
     std::vector<stack_item> stack_;
     int indent_;
     bool indenting_;
     print_double<CharT> fp_;
     buffered_output<CharT> bos_;
+    std::vector<key_cache_entry> key_cache_;
+    std::basic_string<CharT> indent_block_;
 
     // Noncopyable and nonmoveable
     basic_json_serializer(const basic_json_serializer&) = delete;
@@ -122,11 +143,123 @@ public:
     {
     }
 
+
+    basic_json_serializer(basic_output_sink<CharT>& sink)
+       : indent_(0), 
+         indenting_(false),
+         fp_(options_.precision()),
+         bos_(sink)
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<CharT>& sink, bool pprint)
+       : indent_(0), 
+         indenting_(pprint),
+         fp_(options_.precision()),
+         bos_(sink)
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<CharT>& sink, const basic_serialization_options<CharT>& options)
+       : options_(options), 
+         indent_(0), 
+         indenting_(false),  
+         fp_(options_.precision()),
+         bos_(sink)
+    {
+    }
+
+    basic_json_serializer(basic_output_sink<CharT>& sink, const basic_serialization_options<CharT>& options, bool pprint)
+       : options_(options), 
+         indent_(0), 
+         indenting_(pprint),  
+         fp_(options_.precision()),
+         bos_(sink)
+    {
+    }
+
     ~basic_json_serializer()
     {
     }
 
+    // Whether the strings given to the serializer stay unchanged until it
+    // flushes its output, as they do in json::dump, which sets this. Only
+    // then may a sink with a min_reference_length take long runs of them by
+    // reference. Off by default, since handlers such as json_reader pass
+    // strings from buffers that they reuse.
+    void stable_strings(bool value)
+    {
+        bos_.allow_references(value);
+    }
+
+    // Discards the state of any unfinished document, and its output that is
+    // still buffered, so that the serializer can begin another, keeping its
+    // buffer and cached member names. Output of the unfinished document that
+    // the sink has already taken, when it filled the buffer, stays written.
+    void reset()
+    {
+        bos_.discard();
+        stack_.clear();
+        indent_ = 0;
+    }
+
+    // Flushes the buffered output, including that of an unfinished document,
+    // to the old stream or sink, and resets the serializer to write to os
+    void reset(std::basic_ostream<CharT>& os)
+    {
+        bos_.reset(os);
+        reset();
+    }
+
+    // Flushes the buffered output, including that of an unfinished document,
+    // to the old stream or sink, and resets the serializer to write to sink
+    void reset(basic_output_sink<CharT>& sink)
+    {
+        bos_.reset(sink);
+        reset();
+    }
+
 private:
+    // A serializer that writes the members or elements of an open object or
+    // array, from the one at position on, as a serializer with the given
+    // options, indenting and indent, and outer as the innermost object or
+    // array, would write them
+    basic_json_serializer(basic_output_sink<CharT>& sink, 
+                          const basic_serialization_options<CharT>& options, 
+                          bool indenting, 
+                          int indent, 
+                          const stack_item& outer, 
+                          size_t position)
+       : options_(options), 
+         indent_(indent), 
+         indenting_(indenting),  
+         fp_(options_.precision()),
+         bos_(sink)
+    {
+        stack_.push_back(outer);
+        stack_.back().count_ = position;
+    }
+
+    // True if the output of a serializer made with the constructor above
+    // requires the innermost object or array to end on a new line
+    bool part_unindents_at_end() const
+    {
+        return stack_.back().unindent_at_end_;
+    }
+
+    // Writes the output of a serializer made with the constructor above,
+    // for count members or elements
+    void write_part(const CharT* s, size_t length, size_t count, bool unindent_at_end)
+    {
+        JSONCONS_ASSERT(!stack_.empty());
+        bos_.write(s, length);
+        stack_.back().count_ += count;
+        if (unindent_at_end)
+        {
+            stack_.back().unindent_at_end_ = true;
+        }
+    }
+
     // Implementing methods
     void do_begin_json() override
     {
@@ -284,16 +417,57 @@ private:
             }
         }
 
-        bos_.put('\"');
-        escape_string<CharT>(name.data(), name.length(), options_, bos_);
-        bos_.put('\"');
-        bos_.put(':');
+        if (options_.cache_escaped_keys() && name.length() <= max_cached_key_length)
+        {
+            write_cached_name(name);
+        }
+        else
+        {
+            write_name(name, bos_);
+        }
+    }
+
+    void write_name(const string_view_type& name, buffered_output<CharT>& os)
+    {
+        os.put('\"');
+        escape_string<CharT>(name.data(), name.length(), options_, os);
+        os.put('\"');
+        os.put(':');
         if (indenting_)
         {
-            bos_.put(' ');
+            os.put(' ');
         }
     }
 
+    // Writes a name from a small direct mapped cache, indexed by the length
+    // and three of the characters of the name
+    void write_cached_name(const string_view_type& name)
+    {
+        if (key_cache_.empty())
+        {
+            key_cache_.resize(key_cache_size);
+        }
+        const size_t length = name.length();
+        size_t h = length;
+        if (length > 0)
+        {
+            h = h*31 + static_cast<typename std::make_unsigned<CharT>::type>(name[0]);
+            h = h*31 + static_cast<typename std::make_unsigned<CharT>::type>(name[length/2]);
+            h = h*31 + static_cast<typename std::make_unsigned<CharT>::type>(name[length-1]);
+        }
+        key_cache_entry& entry = key_cache_[h & (key_cache_size-1)];
+        if (entry.output.empty() || entry.key.length() != length ||
+            std::char_traits<CharT>::compare(entry.key.data(), name.data(), length) != 0)
+        {
+            entry.key.assign(name.data(), length);
+            entry.output.clear();
+            basic_string_sink<CharT> sink(entry.output);
+            buffered_output<CharT> os(sink);
+            write_name(name, os);
+        }
+        bos_.write(entry.output.data(), entry.output.length());
+    }
+
     void do_null_value() override
     {
         if (!stack_.empty() && !stack_.back().is_object())
@@ -325,7 +499,19 @@ private:
     {
         std::basic_string<CharT> s;
         encode_base64url(data,data+length,s);
-        do_string_value(s);
+
+        if (!stack_.empty() && !stack_.back().is_object())
+        {
+            begin_scalar_value();
+        }
+
+        // Base64url characters need no escaping, and s does not outlive
+        // this call, so it is copied
+        bos_. put('\"');
+        bos_.write(s);
+        bos_. put('\"');
+
+        end_value();
     }
 
     void do_double_value(double value, uint8_t precision) override
@@ -456,20 +642,25 @@ private:
         {
             stack_.back().unindent_at_end_ = true;
         }
-        bos_. put('\n');
-        for (int i = 0; i < indent_; ++i)
-        {
-            bos_. put(' ');
-        }
+        write_new_line();
     }
 
     void write_indent1()
     {
-        bos_. put('\n');
-        for (int i = 0; i < indent_; ++i)
+        write_new_line();
+    }
+
+    // Writes a new line and the current indent in one write, from a block
+    // of a new line followed by spaces that is grown to the deepest indent
+    void write_new_line()
+    {
+        const size_t length = static_cast<size_t>(indent_) + 1;
+        if (indent_block_.length() < length)
         {
-            bos_. put(' ');
+            indent_block_.assign((std::max)(length, 2*indent_block_.length() + 64), ' ');
+            indent_block_[0] = '\n';
         }
+        bos_.write(indent_block_.data(), length);
     }
 };
 
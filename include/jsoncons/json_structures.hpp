@@ -19,16 +19,715 @@
 #include <iomanip>
 #include <utility>
 #include <initializer_list>
+#include <atomic>
+#include <functional>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
 
 namespace jsoncons {
 
+enum class json_type_tag : uint8_t 
+{
+    null_t = 0,
+    empty_object_t,
+    bool_t,
+    integer_t,
+    uinteger_t,
+    double_t,
+    small_string_t,
+    string_t,
+    byte_string_t,
+    array_t,
+    object_t
+};
+
+// is_packing_policy
+
+template <class Policy, class Enable=void>
+struct is_packing_policy : std::false_type {};
+
+template <class Policy>
+struct is_packing_policy<Policy,typename std::enable_if<Policy::pack_numeric_arrays>::type> : std::true_type {};
+
+// is_copy_on_write_policy
+
+template <class Policy, class Enable=void>
+struct is_copy_on_write_policy : std::false_type {};
+
+template <class Policy>
+struct is_copy_on_write_policy<Policy,typename std::enable_if<Policy::copy_on_write>::type> : std::true_type {};
+
+// Json_shared_count_
+
+// Reference count of an array or object that may be shared between
+// copies of a value, empty unless the policy enables copy_on_write
+
+template <bool CopyOnWrite>
+class Json_shared_count_
+{
+public:
+    void add_ref() const
+    {
+    }
+
+    // Returns true if the caller held the last reference
+    bool release() const
+    {
+        return true;
+    }
+
+    bool is_shared() const
+    {
+        return false;
+    }
+};
+
+template <>
+class Json_shared_count_<true>
+{
+    mutable std::atomic<size_t> count_;
+public:
+    Json_shared_count_()
+        : count_(1)
+    {
+    }
+
+    Json_shared_count_(const Json_shared_count_&)
+        : count_(1)
+    {
+    }
+
+    Json_shared_count_& operator=(const Json_shared_count_&)
+    {
+        return *this;
+    }
+
+    void add_ref() const
+    {
+        count_.fetch_add(1,std::memory_order_relaxed);
+    }
+
+    bool release() const
+    {
+        return count_.fetch_sub(1,std::memory_order_acq_rel) == 1;
+    }
+
+    bool is_shared() const
+    {
+        return count_.load(std::memory_order_acquire) > 1;
+    }
+};
+
+// small_string_capacity_of
+
+// Bytes a value holds for a short string, including its terminator,
+// 14 unless the policy defines small_string_capacity
+
+template <class Policy, class Enable=void>
+struct small_string_capacity_of : std::integral_constant<size_t,14> {};
+
+template <class Policy>
+struct small_string_capacity_of<Policy,typename std::enable_if<(Policy::small_string_capacity > 0)>::type> 
+    : std::integral_constant<size_t,Policy::small_string_capacity> {};
+
+// linear_search_threshold_of
+
+// Objects with at most this many members are searched by key equality
+// rather than binary search, 0 unless the policy defines 
+// linear_search_threshold
+
+template <class Policy, class Enable=void>
+struct linear_search_threshold_of : std::integral_constant<size_t,0> {};
+
+template <class Policy>
+struct linear_search_threshold_of<Policy,typename std::enable_if<(Policy::linear_search_threshold > 0)>::type> 
+    : std::integral_constant<size_t,Policy::linear_search_threshold> {};
+
+namespace detail {
+
+// Structural hashing, values that compare equal hash equal. Numbers hash
+// by their double value since integers and doubles compare by value, and
+// object members combine commutatively since member order is not compared.
+
+enum class json_hash_seed : size_t 
+{
+    null_value = 1,
+    bool_value,
+    number_value,
+    string_value,
+    byte_string_value,
+    array_value,
+    object_value
+};
+
+inline
+size_t hash_combine(size_t seed, size_t h)
+{
+    return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+inline
+size_t hash_seed(json_hash_seed seed)
+{
+    return static_cast<size_t>(seed);
+}
+
+inline
+size_t hash_number(double val)
+{
+    // 0.0 == -0.0
+    return hash_combine(hash_seed(json_hash_seed::number_value), std::hash<double>()(val == 0 ? 0.0 : val));
+}
+
+template <class CharT>
+size_t hash_chars(const CharT* s, size_t length)
+{
+    // FNV-1a
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < length; ++i)
+    {
+        h ^= static_cast<size_t>(s[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+inline
+size_t hash_object(size_t length, size_t member_sum)
+{
+    size_t h = hash_combine(hash_combine(hash_seed(json_hash_seed::object_value), length), member_sum);
+    return h != 0 ? h : 1;
+}
+
+}
+
+// json_memory_footprint
+
+// Heap bytes held by a json value and everything below it. Each count
+// includes the container blocks and any unused capacity, but not storage
+// kept inline, such as short strings and the slots of small arrays.
+
+struct json_memory_footprint
+{
+    size_t string_bytes;  // string and byte string values
+    size_t key_bytes;     // member names
+    size_t array_bytes;   // arrays and their element slots
+    size_t object_bytes;  // objects and their member slots
+
+    json_memory_footprint()
+        : string_bytes(0), key_bytes(0), array_bytes(0), object_bytes(0)
+    {
+    }
+
+    size_t total_bytes() const
+    {
+        return string_bytes + key_bytes + array_bytes + object_bytes;
+    }
+
+    json_memory_footprint& operator+=(const json_memory_footprint& other)
+    {
+        string_bytes += other.string_bytes;
+        key_bytes += other.key_bytes;
+        array_bytes += other.array_bytes;
+        object_bytes += other.object_bytes;
+        return *this;
+    }
+};
+
+namespace detail {
+
+// Bytes allocated for the elements of a contiguous container, zero when they
+// are kept within the container itself. terminator is 1 for strings.
+template <class Container>
+size_t heap_capacity_bytes(const Container& c, size_t terminator = 0)
+{
+    typedef typename Container::value_type value_type;
+
+    const void* p = c.data();
+    const void* first = &c;
+    const void* last = reinterpret_cast<const char*>(&c) + sizeof(c);
+    std::less<const void*> less;
+    if (c.capacity() == 0 || (!less(p,first) && less(p,last)))
+    {
+        return 0;
+    }
+    return (c.capacity() + terminator)*sizeof(value_type);
+}
+
+}
+
+// packed_numeric_array
+
+// Contiguous storage for an array whose elements are all int64, all uint64
+// or all double. Each value occupies one 64 bit word, doubles also keep
+// their precision.
+
+template <class Allocator>
+class packed_numeric_array
+{
+public:
+    typedef Allocator allocator_type;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<uint64_t> word_allocator_type;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<uint8_t> precision_allocator_type;
+
+    packed_numeric_array(json_type_tag type, const allocator_type& allocator)
+        : type_(type), 
+          words_(word_allocator_type(allocator)), 
+          precisions_(precision_allocator_type(allocator))
+    {
+    }
+
+    packed_numeric_array(const packed_numeric_array& val, const allocator_type& allocator)
+        : type_(val.type_), 
+          words_(val.words_,word_allocator_type(allocator)), 
+          precisions_(val.precisions_,precision_allocator_type(allocator))
+    {
+    }
+
+    json_type_tag type_id() const
+    {
+        return type_;
+    }
+
+    size_t size() const {return words_.size();}
+
+    size_t capacity() const {return words_.capacity();}
+
+    size_t heap_bytes() const 
+    {
+        return detail::heap_capacity_bytes(words_) + detail::heap_capacity_bytes(precisions_);
+    }
+
+    void reserve(size_t n) 
+    {
+        words_.reserve(n);
+        if (type_ == json_type_tag::double_t)
+        {
+            precisions_.reserve(n);
+        }
+    }
+
+    void clear() 
+    {
+        words_.clear();
+        precisions_.clear();
+    }
+
+    void shrink_to_fit() 
+    {
+        words_.shrink_to_fit();
+        precisions_.shrink_to_fit();
+    }
+
+    int64_t integer_at(size_t i) const
+    {
+        int64_t val;
+        std::memcpy(&val,&words_[i],sizeof(val));
+        return val;
+    }
+
+    uint64_t uinteger_at(size_t i) const
+    {
+        return words_[i];
+    }
+
+    double double_at(size_t i) const
+    {
+        double val;
+        std::memcpy(&val,&words_[i],sizeof(val));
+        return val;
+    }
+
+    uint8_t precision_at(size_t i) const
+    {
+        return precisions_[i];
+    }
+
+    // Appends val if it has the packed type, otherwise returns false
+    template <class Json>
+    bool try_push_back(const Json& val)
+    {
+        if (val.type_id() != type_)
+        {
+            return false;
+        }
+        switch (type_)
+        {
+        case json_type_tag::integer_t:
+            push_back_word(val.as_integer());
+            break;
+        case json_type_tag::uinteger_t:
+            words_.push_back(val.as_uinteger());
+            break;
+        case json_type_tag::double_t:
+            push_back_word(val.as_double());
+            precisions_.push_back(static_cast<uint8_t>(val.double_precision()));
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    // Replaces the value at i if val has the packed type, otherwise returns false
+    template <class Json>
+    bool try_set(size_t i, const Json& val)
+    {
+        if (val.type_id() != type_)
+        {
+            return false;
+        }
+        switch (type_)
+        {
+        case json_type_tag::integer_t:
+            set_word(i,val.as_integer());
+            break;
+        case json_type_tag::uinteger_t:
+            words_[i] = val.as_uinteger();
+            break;
+        case json_type_tag::double_t:
+            set_word(i,val.as_double());
+            precisions_[i] = static_cast<uint8_t>(val.double_precision());
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+
+    template <class Json>
+    Json at(size_t i) const
+    {
+        switch (type_)
+        {
+        case json_type_tag::integer_t:
+            return Json(typename Json::variant(integer_at(i)));
+        case json_type_tag::uinteger_t:
+            return Json(typename Json::variant(uinteger_at(i)));
+        default:
+            return Json(typename Json::variant(double_at(i),precision_at(i)));
+        }
+    }
+
+    template <class T>
+    T value_at(size_t i) const
+    {
+        switch (type_)
+        {
+        case json_type_tag::integer_t:
+            return static_cast<T>(integer_at(i));
+        case json_type_tag::uinteger_t:
+            return static_cast<T>(uinteger_at(i));
+        default:
+            return static_cast<T>(double_at(i));
+        }
+    }
+
+    // True if an array of T has the same layout as the packed words
+    template <class T>
+    bool has_representation() const
+    {
+        switch (type_)
+        {
+        case json_type_tag::integer_t:
+            return std::is_integral<T>::value && std::is_signed<T>::value && sizeof(T) == sizeof(int64_t);
+        case json_type_tag::uinteger_t:
+            return std::is_integral<T>::value && std::is_unsigned<T>::value && sizeof(T) == sizeof(uint64_t);
+        default:
+            return std::is_same<T,double>::value;
+        }
+    }
+
+    // Requires has_representation<T>()
+    template <class T>
+    void copy_to(T* p) const
+    {
+        if (!words_.empty())
+        {
+            std::memcpy(p,words_.data(),words_.size()*sizeof(uint64_t));
+        }
+    }
+
+    template <class Handler>
+    void dump(Handler& handler) const
+    {
+        dump(handler, 0, words_.size());
+    }
+
+    // Emits the elements in [first,last)
+    template <class Handler>
+    void dump(Handler& handler, size_t first, size_t last) const
+    {
+        switch (type_)
+        {
+        case json_type_tag::integer_t:
+            for (size_t i = first; i < last; ++i)
+            {
+                handler.integer_value(integer_at(i));
+            }
+            break;
+        case json_type_tag::uinteger_t:
+            for (size_t i = first; i < last; ++i)
+            {
+                handler.uinteger_value(uinteger_at(i));
+            }
+            break;
+        default:
+            for (size_t i = first; i < last; ++i)
+            {
+                handler.double_value(double_at(i),precision_at(i));
+            }
+            break;
+        }
+    }
+
+    bool operator==(const packed_numeric_array& rhs) const
+    {
+        if (type_ != rhs.type_ || size() != rhs.size())
+        {
+            return false;
+        }
+        if (type_ != json_type_tag::double_t)
+        {
+            return words_ == rhs.words_;
+        }
+        for (size_t i = 0; i < size(); ++i)
+        {
+            if (double_at(i) != rhs.double_at(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+private:
+    json_type_tag type_;
+    std::vector<uint64_t,word_allocator_type> words_;
+    std::vector<uint8_t,precision_allocator_type> precisions_;
+
+    template <class T>
+    void push_back_word(T val)
+    {
+        uint64_t word;
+        std::memcpy(&word,&val,sizeof(word));
+        words_.push_back(word);
+    }
+
+    template <class T>
+    void set_word(size_t i, T val)
+    {
+        std::memcpy(&words_[i],&val,sizeof(uint64_t));
+    }
+
+    packed_numeric_array& operator=(const packed_numeric_array&) = delete;
+};
+
+// json_array_const_iterator
+
+// Const iterator over the elements of a json_array. Over elements it wraps
+// the storage iterator. Over a packed array it holds an index, and makes the
+// element it points to from the packed form into a value that the iterator
+// keeps, so a reference obtained from it is valid only until the iterator is
+// dereferenced again, assigned to or destroyed.
+
+template <class Json, class BaseIterator, class PackedArray>
+class json_array_const_iterator
+{
+public:
+    typedef BaseIterator base_iterator;
+    typedef PackedArray packed_array_type;
+    typedef Json value_type;
+    typedef typename std::iterator_traits<BaseIterator>::difference_type difference_type;
+    typedef const Json* pointer;
+    typedef const Json& reference;
+    typedef std::random_access_iterator_tag iterator_category;
+
+    json_array_const_iterator()
+        : it_(), packed_(nullptr), index_(0)
+    {
+    }
+
+    template <class Iterator,
+              class=typename std::enable_if<std::is_convertible<Iterator,BaseIterator>::value>::type>
+    json_array_const_iterator(Iterator it)
+        : it_(it), packed_(nullptr), index_(0)
+    {
+    }
+
+    json_array_const_iterator(const packed_array_type* packed, size_t index)
+        : it_(), packed_(packed), index_(index)
+    {
+    }
+
+    // The element made from the packed form belongs to each iterator
+    // and is not copied
+    json_array_const_iterator(const json_array_const_iterator& other)
+        : it_(other.it_), packed_(other.packed_), index_(other.index_)
+    {
+    }
+
+    json_array_const_iterator& operator=(const json_array_const_iterator& other)
+    {
+        it_ = other.it_;
+        packed_ = other.packed_;
+        index_ = other.index_;
+        return *this;
+    }
+
+    bool is_packed() const
+    {
+        return packed_ != nullptr;
+    }
+
+    // The index of a position in a packed array
+    size_t index() const
+    {
+        return index_;
+    }
+
+    // The storage iterator of a position in elements
+    base_iterator base() const
+    {
+        return it_;
+    }
+
+    reference operator*() const
+    {
+        if (packed_ != nullptr)
+        {
+            value_ = packed_->template at<Json>(index_);
+            return value_;
+        }
+        return *it_;
+    }
+
+    pointer operator->() const
+    {
+        return std::addressof(**this);
+    }
+
+    json_array_const_iterator& operator++()
+    {
+        if (packed_ != nullptr)
+        {
+            ++index_;
+        }
+        else
+        {
+            ++it_;
+        }
+        return *this;
+    }
+
+    json_array_const_iterator operator++(int)
+    {
+        json_array_const_iterator temp(*this);
+        ++(*this);
+        return temp;
+    }
+
+    json_array_const_iterator& operator--()
+    {
+        if (packed_ != nullptr)
+        {
+            --index_;
+        }
+        else
+        {
+            --it_;
+        }
+        return *this;
+    }
+
+    json_array_const_iterator operator--(int)
+    {
+        json_array_const_iterator temp(*this);
+        --(*this);
+        return temp;
+    }
+
+    json_array_const_iterator& operator+=(difference_type n)
+    {
+        if (packed_ != nullptr)
+        {
+            index_ += n;
+        }
+        else
+        {
+            it_ += n;
+        }
+        return *this;
+    }
+
+    json_array_const_iterator& operator-=(difference_type n)
+    {
+        return *this += -n;
+    }
+
+    friend json_array_const_iterator operator+(json_array_const_iterator it, difference_type n)
+    {
+        return it += n;
+    }
+
+    friend json_array_const_iterator operator+(difference_type n, json_array_const_iterator it)
+    {
+        return it += n;
+    }
+
+    friend json_array_const_iterator operator-(json_array_const_iterator it, difference_type n)
+    {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const json_array_const_iterator& lhs, const json_array_const_iterator& rhs)
+    {
+        return lhs.packed_ != nullptr 
+            ? static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_) 
+            : lhs.it_ - rhs.it_;
+    }
+
+    friend bool operator==(const json_array_const_iterator& lhs, const json_array_const_iterator& rhs)
+    {
+        return lhs.packed_ != nullptr ? lhs.index_ == rhs.index_ : lhs.it_ == rhs.it_;
+    }
+
+    friend bool operator!=(const json_array_const_iterator& lhs, const json_array_const_iterator& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(const json_array_const_iterator& lhs, const json_array_const_iterator& rhs)
+    {
+        return (lhs - rhs) < 0;
+    }
+
+    friend bool operator>(const json_array_const_iterator& lhs, const json_array_const_iterator& rhs)
+    {
+        return rhs < lhs;
+    }
+
+    friend bool operator<=(const json_array_const_iterator& lhs, const json_array_const_iterator& rhs)
+    {
+        return !(rhs < lhs);
+    }
+
+    friend bool operator>=(const json_array_const_iterator& lhs, const json_array_const_iterator& rhs)
+    {
+        return !(lhs < rhs);
+    }
+private:
+    base_iterator it_;
+    const packed_array_type* packed_;
+    size_t index_;
+    mutable Json value_;
+};
+
 // json_array
 
 template <class Json>
-class Json_array_base_
+class Json_array_base_ : public Json_shared_count_<is_copy_on_write_policy<typename Json::implementation_policy>::value>
 {
+    typedef Json_shared_count_<is_copy_on_write_policy<typename Json::implementation_policy>::value> shared_count_base;
 public:
     typedef typename Json::allocator_type allocator_type;
 
@@ -41,6 +740,10 @@ public:
         : self_allocator_(allocator)
     {
     }
+    Json_array_base_(const Json_array_base_& val)
+        : shared_count_base(), self_allocator_(val.self_allocator_)
+    {
+    }
 
     allocator_type get_allocator() const
     {
@@ -62,30 +765,45 @@ public:
 
     typedef typename Json::array_storage_type array_storage_type;
 
+    typedef packed_numeric_array<allocator_type> packed_array_type;
+
     typedef typename array_storage_type::iterator iterator;
-    typedef typename array_storage_type::const_iterator const_iterator;
+    typedef json_array_const_iterator<Json,typename array_storage_type::const_iterator,packed_array_type> const_iterator;
 
     typedef typename std::iterator_traits<iterator>::reference reference;
     typedef typename std::iterator_traits<const_iterator>::reference const_reference;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<packed_array_type> packed_allocator_type;
 
     using Json_array_base_<Json>::get_allocator;
 
     json_array()
         : Json_array_base_<Json>(), 
-          elements_()
+          elements_(),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
     }
 
     explicit json_array(const allocator_type& allocator)
         : Json_array_base_<Json>(allocator), 
-          elements_(val_allocator_type(allocator))
+          elements_(val_allocator_type(allocator)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
     }
 
     explicit json_array(size_t n, 
                         const allocator_type& allocator = allocator_type())
         : Json_array_base_<Json>(allocator), 
-          elements_(n,Json(),val_allocator_type(allocator))
+          elements_(n,Json(),val_allocator_type(allocator)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
     }
 
@@ -93,67 +811,159 @@ public:
                         const Json& value, 
                         const allocator_type& allocator = allocator_type())
         : Json_array_base_<Json>(allocator), 
-          elements_(n,value,val_allocator_type(allocator))
+          elements_(n,value,val_allocator_type(allocator)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
     }
 
     template <class InputIterator>
     json_array(InputIterator begin, InputIterator end, const allocator_type& allocator = allocator_type())
         : Json_array_base_<Json>(allocator), 
-          elements_(begin,end,val_allocator_type(allocator))
+          elements_(begin,end,val_allocator_type(allocator)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
     }
     json_array(const json_array& val)
         : Json_array_base_<Json>(val.get_allocator()),
-          elements_(val.elements_)
+          elements_(val.elements_),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
+        if (val.packed_ != nullptr)
+        {
+            create_packed(*(val.packed_),get_allocator());
+        }
     }
     json_array(const json_array& val, const allocator_type& allocator)
         : Json_array_base_<Json>(allocator), 
-          elements_(val.elements_,val_allocator_type(allocator))
+          elements_(val.elements_,val_allocator_type(allocator)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
+        if (val.packed_ != nullptr)
+        {
+            create_packed(*(val.packed_),allocator);
+        }
     }
 
     json_array(json_array&& val) JSONCONS_NOEXCEPT
         : Json_array_base_<Json>(val.get_allocator()), 
-          elements_(std::move(val.elements_))
+          elements_(std::move(val.elements_)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
+        ++val.modifications_;
+        std::swap(val.packed_,packed_);
+        swap_blocks(val);
     }
     json_array(json_array&& val, const allocator_type& allocator)
         : Json_array_base_<Json>(allocator), 
-          elements_(std::move(val.elements_),val_allocator_type(allocator))
-    {
+          elements_(std::move(val.elements_),val_allocator_type(allocator)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
+    {
+        ++val.modifications_;
+        if (val.packed_ != nullptr)
+        {
+            // The packed form can only be taken over if it was allocated
+            // with an equal allocator
+            if (allocator == val.get_allocator())
+            {
+                std::swap(val.packed_,packed_);
+                swap_blocks(val);
+            }
+            else
+            {
+                create_packed(*(val.packed_),allocator);
+            }
+        }
     }
 
     json_array(std::initializer_list<Json> init)
         : Json_array_base_<Json>(), 
-          elements_(std::move(init))
+          elements_(std::move(init)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
     }
 
     json_array(std::initializer_list<Json> init, 
                const allocator_type& allocator)
         : Json_array_base_<Json>(allocator), 
-          elements_(std::move(init),val_allocator_type(allocator))
+          elements_(std::move(init),val_allocator_type(allocator)),
+          packed_(nullptr),
+          blocks_(nullptr),
+          id_(0),
+          modifications_(0)
     {
     }
     ~json_array()
     {
+        destroy_packed();
     }
 
     void swap(json_array<Json>& val)
     {
+        ++modifications_;
+        ++val.modifications_;
         elements_.swap(val.elements_);
+        std::swap(val.packed_,packed_);
+        swap_blocks(val);
+    }
+
+    // Appends copies of the elements of val made by copy, which lets
+    // basic_json copy nested arrays and objects without recursion
+    template <class UnaryOperation>
+    void copy_elements_(const json_array& val, UnaryOperation copy)
+    {
+        if (val.packed_ != nullptr)
+        {
+            create_packed(*(val.packed_),get_allocator());
+        }
+        else
+        {
+            elements_.reserve(val.elements_.size());
+            for (const auto& element : val.elements_)
+            {
+                elements_.emplace_back(copy(element));
+            }
+        }
     }
 
-    size_t size() const {return elements_.size();}
+    size_t size() const {return packed_ != nullptr ? packed_->size() : elements_.size();}
 
-    size_t capacity() const {return elements_.capacity();}
+    size_t capacity() const {return packed_ != nullptr ? packed_->capacity() : elements_.capacity();}
 
-    void clear() {elements_.clear();}
+    void clear() 
+    {
+        ++modifications_;
+        destroy_packed();
+        elements_.clear();
+    }
 
     void shrink_to_fit() 
     {
+        if (packed_ != nullptr)
+        {
+            packed_->shrink_to_fit();
+            return;
+        }
         for (size_t i = 0; i < elements_.size(); ++i)
         {
             elements_[i].shrink_to_fit();
@@ -161,32 +971,178 @@ public:
         elements_.shrink_to_fit();
     }
 
-    void reserve(size_t n) {elements_.reserve(n);}
+    void reserve(size_t n) 
+    {
+        if (packed_ != nullptr)
+        {
+            packed_->reserve(n);
+        }
+        else
+        {
+            elements_.reserve(n);
+        }
+    }
 
-    void resize(size_t n) {elements_.resize(n);}
+    void resize(size_t n) 
+    {
+        unpack();
+        elements_.resize(n);
+    }
 
-    void resize(size_t n, const Json& val) {elements_.resize(n,val);}
+    void resize(size_t n, const Json& val) 
+    {
+        unpack();
+        elements_.resize(n,val);
+    }
 
     void remove_range(size_t from_index, size_t to_index) 
     {
+        unpack();
         JSONCONS_ASSERT(from_index <= to_index);
         JSONCONS_ASSERT(to_index <= elements_.size());
         elements_.erase(elements_.begin()+from_index,elements_.begin()+to_index);
     }
 
+    // An iterator obtained by const access to a packed array holds an 
+    // index, which stays valid when the array is unpacked, so positions 
+    // are accepted from either
     void erase(const_iterator pos) 
     {
-        elements_.erase(pos);
+        elements_.erase(position(pos));
     }
 
     void erase(const_iterator first, const_iterator last) 
     {
-        elements_.erase(first,last);
+        storage_const_iterator it = position(first);
+        elements_.erase(it, it + (last - first));
+    }
+
+    Json& operator[](size_t i) 
+    {
+        unpack();
+        return elements_[i];
+    }
+
+    const Json& operator[](size_t i) const 
+    {
+        return packed_ != nullptr ? packed_element(i) : elements_[i];
+    }
+
+    // Moves the elements into a packed_numeric_array if there is at least one
+    // and they are all int64, all uint64 or all double. A packed array is 
+    // converted back to elements on the first non-const access by reference 
+    // or iterator, or on the first push_back of a value of a different type.
+    // Const iterators make each element from the packed form as they reach 
+    // it. Const access by index returns a reference into a block of 
+    // block_length elements made from the packed form when first needed and 
+    // kept until the next non-const operation, so that concurrent const 
+    // reads do not modify the array. Indexing every element keeps as many 
+    // elements as unpacking would.
+    bool pack()
+    {
+        if (packed_ != nullptr)
+        {
+            return true;
+        }
+        if (elements_.empty())
+        {
+            return false;
+        }
+        const json_type_tag type = elements_.front().type_id();
+        if (type != json_type_tag::integer_t && type != json_type_tag::uinteger_t && type != json_type_tag::double_t)
+        {
+            return false;
+        }
+        for (const auto& element : elements_)
+        {
+            if (element.type_id() != type)
+            {
+                return false;
+            }
+        }
+
+        create_packed(type,get_allocator());
+        try
+        {
+            packed_->reserve(elements_.size());
+            for (const auto& element : elements_)
+            {
+                packed_->try_push_back(element);
+            }
+        }
+        catch (...)
+        {
+            destroy_packed();
+            throw;
+        }
+        val_allocator_type alloc(get_allocator());
+        array_storage_type empty(alloc);
+        elements_.swap(empty);
+        return true;
+    }
+
+    bool is_packed() const
+    {
+        return packed_ != nullptr;
+    }
+
+    const packed_array_type& packed() const
+    {
+        JSONCONS_ASSERT(packed_ != nullptr);
+        return *packed_;
+    }
+
+    // Identifies this array object among the arrays of its type. Assigned
+    // on first request and never reused.
+    size_t id() const
+    {
+        static std::atomic<size_t> next_id(0);
+
+        size_t n = id_.load(std::memory_order_acquire);
+        if (n == 0)
+        {
+            size_t expected = 0;
+            n = next_id.fetch_add(1, std::memory_order_relaxed) + 1;
+            if (!id_.compare_exchange_strong(expected, n, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                n = expected;
+            }
+        }
+        return n;
     }
 
-    Json& operator[](size_t i) {return elements_[i];}
+    // Incremented by every non-const operation that can change the elements
+    // or return a non-const reference or iterator to one. Together with id()
+    // it tells a holder of positions that the array is unchanged, unless it
+    // was modified through a reference or iterator obtained before.
+    size_t modification_count() const
+    {
+        return modifications_;
+    }
 
-    const Json& operator[](size_t i) const {return elements_[i];}
+    // Bytes allocated for the element slots, or for the packed form and
+    // any blocks of elements made for const access by index
+    size_t heap_bytes() const
+    {
+        size_t n = detail::heap_capacity_bytes(elements_);
+        if (packed_ != nullptr)
+        {
+            n += sizeof(packed_array_type) + packed_->heap_bytes();
+            const block_table_type* table = blocks_.load(std::memory_order_acquire);
+            if (table != nullptr)
+            {
+                n += sizeof(block_table_type) + detail::heap_capacity_bytes(*table);
+                for (size_t b = 0; b < table->size(); ++b)
+                {
+                    if ((*table)[b].load(std::memory_order_acquire) != nullptr)
+                    {
+                        n += block_size(b)*sizeof(Json);
+                    }
+                }
+            }
+        }
+        return n;
+    }
 
     // push_back
 
@@ -194,50 +1150,69 @@ public:
     typename std::enable_if<is_stateless<A>::value,void>::type 
     push_back(T&& value)
     {
-        elements_.emplace_back(std::forward<T>(value));
+        ++modifications_;
+        if (packed_ != nullptr)
+        {
+            push_back_packed(Json(std::forward<T>(value)));
+        }
+        else
+        {
+            elements_.emplace_back(std::forward<T>(value));
+        }
     }
 
     template <class T, class A=allocator_type>
     typename std::enable_if<!is_stateless<A>::value,void>::type 
     push_back(T&& value)
     {
-        elements_.emplace_back(std::forward<T>(value),get_allocator());
+        ++modifications_;
+        if (packed_ != nullptr)
+        {
+            push_back_packed(Json(std::forward<T>(value),get_allocator()));
+        }
+        else
+        {
+            elements_.emplace_back(std::forward<T>(value),get_allocator());
+        }
     }
 
     template <class T, class A=allocator_type>
     typename std::enable_if<is_stateless<A>::value,iterator>::type 
     insert(const_iterator pos, T&& value)
     {
+        storage_const_iterator p = position(pos);
 #if defined(__GNUC__) && __GNUC__ == 4 && __GNUC_MINOR__ < 9
     // work around https://gcc.gnu.org/bugzilla/show_bug.cgi?id=54577
-        iterator it = elements_.begin() + (pos - elements_.begin());
+        iterator it = elements_.begin() + (p - elements_.begin());
         return elements_.emplace(it, std::forward<T>(value));
 #else
-        return elements_.emplace(pos, std::forward<T>(value));
+        return elements_.emplace(p, std::forward<T>(value));
 #endif
     }
     template <class T, class A=allocator_type>
     typename std::enable_if<!is_stateless<A>::value,iterator>::type 
     insert(const_iterator pos, T&& value)
     {
+        storage_const_iterator p = position(pos);
 #if defined(__GNUC__) && __GNUC__ == 4 && __GNUC_MINOR__ < 9
     // work around https://gcc.gnu.org/bugzilla/show_bug.cgi?id=54577
-        iterator it = elements_.begin() + (pos - elements_.begin());
+        iterator it = elements_.begin() + (p - elements_.begin());
         return elements_.emplace(it, std::forward<T>(value), get_allocator());
 #else
-        return elements_.emplace(pos, std::forward<T>(value), get_allocator());
+        return elements_.emplace(p, std::forward<T>(value), get_allocator());
 #endif
     }
 
     template <class InputIt>
     iterator insert(const_iterator pos, InputIt first, InputIt last)
     {
+        storage_const_iterator p = position(pos);
 #if defined(__GNUC__) && __GNUC__ == 4 && __GNUC_MINOR__ < 9
     // work around https://gcc.gnu.org/bugzilla/show_bug.cgi?id=54577
-        iterator it = elements_.begin() + (pos - elements_.begin());
+        iterator it = elements_.begin() + (p - elements_.begin());
         return elements_.insert(it, first, last);
 #else
-        return elements_.insert(pos, first, last);
+        return elements_.insert(p, first, last);
 #endif
     }
 
@@ -247,7 +1222,8 @@ public:
     typename std::enable_if<is_stateless<A>::value,iterator>::type 
     emplace(const_iterator pos, Args&&... args)
     {
-        iterator it = elements_.begin() + (pos - elements_.begin());
+        storage_const_iterator p = position(pos);
+        iterator it = elements_.begin() + (p - elements_.begin());
         return elements_.emplace(it, std::forward<Args>(args)...);
     }
 #else
@@ -255,41 +1231,313 @@ public:
     typename std::enable_if<is_stateless<A>::value,iterator>::type 
     emplace(const_iterator pos, Args&&... args)
     {
-        return elements_.emplace(pos, std::forward<Args>(args)...);
+        return elements_.emplace(position(pos), std::forward<Args>(args)...);
     }
 #endif
     template <class... Args>
     Json& emplace_back(Args&&... args)
     {
+        unpack();
         elements_.emplace_back(std::forward<Args>(args)...);
         return elements_.back();
     }
 
-    iterator begin() {return elements_.begin();}
+    iterator begin() 
+    {
+        unpack();
+        return elements_.begin();
+    }
+
+    iterator end() 
+    {
+        unpack();
+        return elements_.end();
+    }
+
+    const_iterator begin() const 
+    {
+        return packed_ != nullptr ? const_iterator(to_plain_pointer(packed_), 0) : const_iterator(elements_.begin());
+    }
+
+    const_iterator end() const 
+    {
+        return packed_ != nullptr ? const_iterator(to_plain_pointer(packed_), packed_->size()) : const_iterator(elements_.end());
+    }
+
+    size_t hash_code() const
+    {
+        size_t h = detail::hash_combine(detail::hash_seed(detail::json_hash_seed::array_value), size());
+        if (packed_ != nullptr)
+        {
+            for (size_t i = 0; i < packed_->size(); ++i)
+            {
+                h = detail::hash_combine(h, detail::hash_number(packed_->template value_at<double>(i)));
+            }
+        }
+        else
+        {
+            for (const auto& element : elements_)
+            {
+                h = detail::hash_combine(h, element.hash_code());
+            }
+        }
+        return h;
+    }
+
+    bool operator==(const json_array<Json>& rhs) const
+    {
+        if (size() != rhs.size())
+        {
+            return false;
+        }
+        if (packed_ != nullptr && rhs.packed_ != nullptr)
+        {
+            if (packed_->type_id() == rhs.packed_->type_id())
+            {
+                return *packed_ == *(rhs.packed_);
+            }
+            for (size_t i = 0; i < size(); ++i)
+            {
+                if (packed_->template at<Json>(i) != rhs.packed_->template at<Json>(i))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+        if (packed_ != nullptr)
+        {
+            return equal_packed(*packed_, rhs.elements_);
+        }
+        if (rhs.packed_ != nullptr)
+        {
+            return equal_packed(*(rhs.packed_), elements_);
+        }
+        for (size_t i = 0; i < size(); ++i)
+        {
+            if (elements_[i] != rhs.elements_[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+private:
+    typedef typename std::allocator_traits<packed_allocator_type>::pointer packed_pointer;
+    typedef typename array_storage_type::const_iterator storage_const_iterator;
+    typedef typename std::allocator_traits<val_allocator_type>::pointer val_pointer;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<std::atomic<Json*>> block_pointer_allocator_type;
+    typedef std::vector<std::atomic<Json*>,block_pointer_allocator_type> block_table_type;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<block_table_type> block_table_allocator_type;
+    typedef typename std::allocator_traits<block_table_allocator_type>::pointer block_table_pointer;
+
+    static const size_t block_length = 64;
+
+    array_storage_type elements_;
+    packed_pointer packed_;
+    // Blocks of elements of a packed array, each made on the first const 
+    // access by index to one of its elements. The table and the blocks are
+    // published with compare and exchange, and destroyed only by non-const
+    // operations.
+    mutable std::atomic<block_table_type*> blocks_;
+    mutable std::atomic<size_t> id_;
+    size_t modifications_;
+
+    static bool equal_packed(const packed_array_type& packed, const array_storage_type& elements)
+    {
+        for (size_t i = 0; i < packed.size(); ++i)
+        {
+            if (elements[i] != packed.template at<Json>(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Unpacks the array if pos is a position in the packed form, and 
+    // returns the position in the elements
+    storage_const_iterator position(const_iterator pos)
+    {
+        unpack();
+        return pos.is_packed() ? storage_const_iterator(elements_.begin() + pos.index()) : pos.base();
+    }
+
+    const Json& packed_element(size_t i) const
+    {
+        block_table_type* table = blocks_.load(std::memory_order_acquire);
+        if (table == nullptr)
+        {
+            block_table_allocator_type alloc(get_allocator());
+            block_table_pointer ptr = alloc.allocate(1);
+            try
+            {
+                std::allocator_traits<block_table_allocator_type>::construct(alloc, to_plain_pointer(ptr), 
+                                                                              (packed_->size() + block_length - 1)/block_length,
+                                                                              block_pointer_allocator_type(get_allocator()));
+            }
+            catch (...)
+            {
+                alloc.deallocate(ptr,1);
+                throw;
+            }
+            table = to_plain_pointer(ptr);
+            block_table_type* expected = nullptr;
+            if (!blocks_.compare_exchange_strong(expected, table, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                // Another thread published its table first
+                free_block_table(table);
+                table = expected;
+            }
+        }
+
+        const size_t b = i / block_length;
+        Json* block = (*table)[b].load(std::memory_order_acquire);
+        if (block == nullptr)
+        {
+            block = make_block(b);
+            Json* expected = nullptr;
+            if (!(*table)[b].compare_exchange_strong(expected, block, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                // Another thread published its block first
+                free_block(block, block_size(b));
+                block = expected;
+            }
+        }
+        return block[i % block_length];
+    }
+
+    size_t block_size(size_t b) const
+    {
+        const size_t n = packed_->size() - b*block_length;
+        return n < block_length ? n : block_length;
+    }
+
+    Json* make_block(size_t b) const
+    {
+        const size_t n = block_size(b);
+        val_allocator_type alloc(get_allocator());
+        val_pointer ptr = alloc.allocate(n);
+        Json* p = to_plain_pointer(ptr);
+        size_t count = 0;
+        try
+        {
+            for (; count < n; ++count)
+            {
+                std::allocator_traits<val_allocator_type>::construct(alloc, p + count, packed_->template at<Json>(b*block_length + count));
+            }
+        }
+        catch (...)
+        {
+            for (size_t k = 0; k < count; ++k)
+            {
+                std::allocator_traits<val_allocator_type>::destroy(alloc, p + k);
+            }
+            alloc.deallocate(ptr,n);
+            throw;
+        }
+        return p;
+    }
+
+    void free_block(Json* p, size_t n) const
+    {
+        val_allocator_type alloc(get_allocator());
+        for (size_t k = 0; k < n; ++k)
+        {
+            std::allocator_traits<val_allocator_type>::destroy(alloc, p + k);
+        }
+        alloc.deallocate(std::pointer_traits<val_pointer>::pointer_to(*p),n);
+    }
+
+    void free_block_table(block_table_type* table) const
+    {
+        block_table_allocator_type alloc(get_allocator());
+        std::allocator_traits<block_table_allocator_type>::destroy(alloc, table);
+        alloc.deallocate(std::pointer_traits<block_table_pointer>::pointer_to(*table),1);
+    }
 
-    iterator end() {return elements_.end();}
+    void destroy_blocks()
+    {
+        block_table_type* table = blocks_.load(std::memory_order_relaxed);
+        if (table != nullptr)
+        {
+            blocks_.store(nullptr, std::memory_order_relaxed);
+            for (size_t b = 0; b < table->size(); ++b)
+            {
+                Json* block = (*table)[b].load(std::memory_order_relaxed);
+                if (block != nullptr)
+                {
+                    free_block(block, block_size(b));
+                }
+            }
+            free_block_table(table);
+        }
+    }
 
-    const_iterator begin() const {return elements_.begin();}
+    void swap_blocks(json_array& val)
+    {
+        block_table_type* table = blocks_.load(std::memory_order_relaxed);
+        blocks_.store(val.blocks_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        val.blocks_.store(table, std::memory_order_relaxed);
+    }
 
-    const_iterator end() const {return elements_.end();}
+    template <typename... Args>
+    void create_packed(Args&& ... args)
+    {
+        packed_allocator_type alloc(get_allocator());
+        packed_pointer ptr = alloc.allocate(1);
+        try
+        {
+            std::allocator_traits<packed_allocator_type>::construct(alloc, to_plain_pointer(ptr), std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            alloc.deallocate(ptr,1);
+            throw;
+        }
+        packed_ = ptr;
+    }
 
-    bool operator==(const json_array<Json>& rhs) const
+    void destroy_packed()
     {
-        if (size() != rhs.size())
+        destroy_blocks();
+        if (packed_ != nullptr)
         {
-            return false;
+            packed_allocator_type alloc(get_allocator());
+            std::allocator_traits<packed_allocator_type>::destroy(alloc, to_plain_pointer(packed_));
+            alloc.deallocate(packed_,1);
+            packed_ = nullptr;
         }
-        for (size_t i = 0; i < size(); ++i)
+    }
+
+    // Called by every non-const operation that can change the elements or 
+    // return a non-const reference or iterator to one
+    void unpack()
+    {
+        ++modifications_;
+        if (packed_ != nullptr)
         {
-            if (elements_[i] != rhs.elements_[i])
+            val_allocator_type alloc(get_allocator());
+            array_storage_type elements(alloc);
+            elements.reserve(packed_->capacity());
+            for (size_t i = 0; i < packed_->size(); ++i)
             {
-                return false;
+                elements.push_back(packed_->template at<Json>(i));
             }
+            elements_.swap(elements);
+            destroy_packed();
+        }
+    }
+
+    void push_back_packed(Json&& value)
+    {
+        destroy_blocks();
+        if (!packed_->try_push_back(value))
+        {
+            unpack();
+            elements_.push_back(std::move(value));
         }
-        return true;
     }
-private:
-    array_storage_type elements_;
 
     json_array& operator=(const json_array<Json>&) = delete;
 };
@@ -305,8 +1553,8 @@ BidirectionalIt last_wins_unique_sequence(BidirectionalIt first, BidirectionalIt
         return last;
     }
 
-    typedef typename BidirectionalIt::value_type value_type;
-    typedef typename BidirectionalIt::pointer pointer;
+    typedef typename std::iterator_traits<BidirectionalIt>::value_type value_type;
+    typedef typename std::iterator_traits<BidirectionalIt>::pointer pointer;
     std::vector<value_type> dups;
     {
         std::vector<pointer> v(std::distance(first,last));
@@ -414,6 +1662,11 @@ public:
         return string_view_type(key_.data(),key_.size());
     }
 
+    size_t key_heap_bytes() const
+    {
+        return detail::heap_capacity_bytes(key_,1);
+    }
+
     ValueT& value()
     {
         return value_;
@@ -473,8 +1726,9 @@ private:
 };
 
 template <class KeyT,class Json>
-class Json_object_
+class Json_object_ : public Json_shared_count_<is_copy_on_write_policy<typename Json::implementation_policy>::value>
 {
+    typedef Json_shared_count_<is_copy_on_write_policy<typename Json::implementation_policy>::value> shared_count_base;
 public:
     typedef typename Json::allocator_type allocator_type;
     typedef typename Json::char_type char_type;
@@ -504,7 +1758,7 @@ public:
     }
 
     Json_object_(const Json_object_& val)
-        : self_allocator_(val.get_allocator()), members_(val.members_)
+        : shared_count_base(), self_allocator_(val.get_allocator()), members_(val.members_)
     {
     }
 
@@ -515,7 +1769,7 @@ public:
     }
 
     Json_object_(const Json_object_& val, const allocator_type& allocator) :
-        self_allocator_(allocator), 
+        shared_count_base(), self_allocator_(allocator), 
         members_(val.members_,kvp_allocator_type(allocator))
     {
     }
@@ -525,11 +1779,57 @@ public:
     {
     }
 
+    Json_object_(object_storage_type&& members,const allocator_type& allocator) :
+        self_allocator_(allocator), members_(std::move(members))
+    {
+    }
+
     void swap(Json_object_& val)
     {
         members_.swap(val.members_);
     }
 
+    // Bytes allocated for the member slots
+    size_t heap_bytes() const
+    {
+        return detail::heap_capacity_bytes(members_);
+    }
+
+    // Bytes allocated for the member names
+    size_t key_heap_bytes() const
+    {
+        size_t n = 0;
+        for (const auto& member : members_)
+        {
+            n += member.key_heap_bytes();
+        }
+        return n;
+    }
+
+    // Appends the members of val in order, with values copied by copy,
+    // which lets basic_json copy nested arrays and objects without recursion
+    template <class UnaryOperation>
+    void copy_members_(const Json_object_& val, UnaryOperation copy)
+    {
+        members_.reserve(val.members_.size());
+        for (const auto& member : val.members_)
+        {
+            members_.emplace_back(key_storage_type(member.key().begin(),member.key().end(),char_allocator_type(get_allocator())), 
+                                  copy(member.value()));
+        }
+    }
+
+    size_t hash_code() const
+    {
+        size_t member_sum = 0;
+        for (const auto& member : members_)
+        {
+            member_sum += detail::hash_combine(detail::hash_chars(member.key().data(),member.key().length()), 
+                                               member.value().hash_code());
+        }
+        return detail::hash_object(members_.size(), member_sum);
+    }
+
     allocator_type get_allocator() const
     {
         return this->self_allocator_;
@@ -560,6 +1860,10 @@ public:
     using typename Json_object_<KeyT,Json>::const_iterator;
     using Json_object_<KeyT,Json>::get_allocator;
 
+    // Objects with at most this many members are searched by key equality
+    // rather than binary search, set by the small storage policies
+    static const size_t linear_search_threshold = linear_search_threshold_of<typename Json::implementation_policy>::value;
+
     json_object()
         : Json_object_<KeyT,Json>()
     {
@@ -589,6 +1893,14 @@ public:
     {
     }
 
+    // Takes members in any order, as collected by basic_object_builder, and
+    // sorts them once, the last member with a duplicate key winning
+    json_object(object_storage_type&& members,const allocator_type& allocator)
+        : Json_object_<KeyT,Json>(std::move(members),allocator)
+    {
+        normalize_members_();
+    }
+
     json_object(std::initializer_list<typename Json::array> init)
         : Json_object_<KeyT,Json>()
     {
@@ -686,6 +1998,11 @@ public:
 
     iterator find(const string_view_type& name)
     {
+        if (this->members_.size() <= linear_search_threshold)
+        {
+            return std::find_if(this->members_.begin(),this->members_.end(), 
+                                [name](const value_type& a){return a.key() == name;});
+        }
         auto it = std::lower_bound(this->members_.begin(),this->members_.end(), name, 
                                    [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
         auto result = (it != this->members_.end() && it->key() == name) ? it : this->members_.end();
@@ -694,6 +2011,11 @@ public:
 
     const_iterator find(const string_view_type& name) const
     {
+        if (this->members_.size() <= linear_search_threshold)
+        {
+            return std::find_if(this->members_.begin(),this->members_.end(), 
+                                [name](const value_type& a){return a.key() == name;});
+        }
         auto it = std::lower_bound(this->members_.begin(),this->members_.end(), 
                                    name, 
                                    [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});
@@ -730,144 +2052,93 @@ public:
         {
             this->members_.emplace_back(pred(*s));
         }
-        std::stable_sort(this->members_.begin(),this->members_.end(),
-                         [](const value_type& a, const value_type& b){return a.key().compare(b.key()) < 0;});
-        auto it = std::unique(this->members_.rbegin(), this->members_.rend(),
-                              [](const value_type& a, const value_type& b){ return !(a.key().compare(b.key()));});
-        this->members_.erase(this->members_.begin(),it.base());
+        normalize_members_();
     }
 
     // merge
 
+    // Both objects are sorted, so merge and merge_or_update combine them in
+    // one linear pass into new storage, see merge_members_
+
     void merge(const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
-        {
-            try_emplace(it->key(),it->value());
-        }
+        merge_members_(source.begin(), source.end(), false);
     }
 
     void merge(json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
-        {
-            auto pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                        [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});   
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-            }
-            else if (it->key() != pos->key())
-            {
-                this->members_.emplace(pos,*it);
-            }
-        }
+        merge_members_(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), false);
     }
 
-    void merge(iterator hint, const json_object& source)
+    void merge(iterator, const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
-        {
-            hint = try_emplace(hint, it->key(),it->value());
-        }
+        merge(source);
     }
 
-    void merge(iterator hint, json_object&& source)
+    void merge(iterator, json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
-        {
-            iterator pos;
-            if (hint != this->members_.end() && hint->key() <= it->key())
-            {
-                pos = std::lower_bound(hint,this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            else
-            {
-                pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-                hint = this->members_.begin() + (this->members_.size() - 1);
-            }
-            else if (it->key() != pos->key())
-            {
-                hint = this->members_.emplace(pos,*it);
-            }
-        }
+        merge(std::move(source));
     }
 
     // merge_or_update
 
     void merge_or_update(const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
-        {
-            insert_or_assign(it->key(),it->value());
-        }
+        merge_members_(source.begin(), source.end(), true);
     }
 
     void merge_or_update(json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
-        {
-            auto pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                        [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});   
-            if (pos == this->members_.end() )
-            {
-                this->members_.emplace_back(*it);
-            }
-            else 
-            {
-                pos->value(it->value());
-            }
-        }
+        merge_members_(std::make_move_iterator(source.begin()), std::make_move_iterator(source.end()), true);
     }
 
-    void merge_or_update(iterator hint, const json_object& source)
+    void merge_or_update(iterator, const json_object& source)
     {
-        for (auto it = source.begin(); it != source.end(); ++it)
-        {
-            hint = insert_or_assign(hint, it->key(),it->value());
-        }
+        merge_or_update(source);
     }
 
-    void merge_or_update(iterator hint, json_object&& source)
+    void merge_or_update(iterator, json_object&& source)
     {
-        auto it = std::make_move_iterator(source.begin());
-        auto end = std::make_move_iterator(source.end());
-        for (; it != end; ++it)
+        merge_or_update(std::move(source));
+    }
+
+    // erase_keys
+
+    // Erases the members with the given keys, in any order, in one pass
+    // over the members after sorting the keys
+    template <class InputIt>
+    void erase_keys(InputIt first, InputIt last)
+    {
+        std::vector<string_view_type> keys;
+        for (; first != last; ++first)
         {
-            iterator pos;
-            if (hint != this->members_.end() && hint->key() <= it->key())
-            {
-                pos = std::lower_bound(hint,this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            else
-            {
-                pos = std::lower_bound(this->members_.begin(),this->members_.end(), it->key(), 
-                                      [](const value_type& a, const string_view_type& k){return a.key().compare(k) < 0;});        
-            }
-            if (pos == this->members_.end() )
+            keys.push_back(string_view_type(*first));
+        }
+        if (keys.empty())
+        {
+            return;
+        }
+        std::sort(keys.begin(), keys.end(),
+                  [](const string_view_type& a, const string_view_type& b){return a.compare(b) < 0;});
+
+        auto key = keys.begin();
+        auto pos = this->members_.begin();
+        for (auto it = this->members_.begin(); it != this->members_.end(); ++it)
+        {
+            while (key != keys.end() && key->compare(it->key()) < 0)
             {
-                this->members_.emplace_back(*it);
-                hint = this->members_.begin() + (this->members_.size() - 1);
+                ++key;
             }
-            else 
+            if (key == keys.end() || it->key() != *key)
             {
-                pos->value(it->value());
-                hint = pos;
+                if (pos != it)
+                {
+                    *pos = std::move(*it);
+                }
+                ++pos;
             }
         }
+        this->members_.erase(pos, this->members_.end());
     }
 
     // insert_or_assign
@@ -1268,6 +2539,99 @@ public:
     }
 private:
     json_object& operator=(const json_object&) = delete;
+
+    // Merges the sorted members [first,last) with the members of this object.
+    // Where both have a key, update selects the member from [first,last).
+    // The members taken from [first,last) are copied before any member of
+    // this object is moved, so if a copy throws, this object is unchanged
+    template <class InputIt>
+    void merge_members_(InputIt first, InputIt last, bool update)
+    {
+        if (first == last)
+        {
+            return;
+        }
+        object_storage_type incoming((kvp_allocator_type(get_allocator())));
+        incoming.reserve(std::distance(first,last));
+
+        auto it = this->members_.begin();
+        auto end = this->members_.end();
+        for (; first != last; ++first)
+        {
+            while (it != end && it->key().compare(first->key()) < 0)
+            {
+                ++it;
+            }
+            if (update || it == end || it->key() != first->key())
+            {
+                append_member_(incoming, *first, is_stateless<allocator_type>());
+            }
+        }
+        if (incoming.empty())
+        {
+            return;
+        }
+
+        object_storage_type merged((kvp_allocator_type(get_allocator())));
+        merged.reserve(this->members_.size() + incoming.size());
+
+        it = this->members_.begin();
+        auto in = incoming.begin();
+        while (it != end && in != incoming.end())
+        {
+            int c = it->key().compare(in->key());
+            if (c < 0)
+            {
+                merged.emplace_back(std::move(*it));
+                ++it;
+            }
+            else
+            {
+                merged.emplace_back(std::move(*in));
+                if (c == 0)
+                {
+                    ++it;
+                }
+                ++in;
+            }
+        }
+        for (; it != end; ++it)
+        {
+            merged.emplace_back(std::move(*it));
+        }
+        for (; in != incoming.end(); ++in)
+        {
+            merged.emplace_back(std::move(*in));
+        }
+        this->members_.swap(merged);
+    }
+
+    template <class Stateless>
+    void append_member_(object_storage_type& storage, value_type&& member, Stateless)
+    {
+        storage.emplace_back(std::move(member));
+    }
+
+    void append_member_(object_storage_type& storage, const value_type& member, std::true_type)
+    {
+        storage.emplace_back(member);
+    }
+
+    void append_member_(object_storage_type& storage, const value_type& member, std::false_type)
+    {
+        storage.emplace_back(key_storage_type(member.key().begin(),member.key().end(),get_allocator()), 
+                             member.value(), get_allocator());
+    }
+
+    // Sorts the members by key, the last of members with equal keys winning
+    void normalize_members_()
+    {
+        std::stable_sort(this->members_.begin(),this->members_.end(),
+                         [](const value_type& a, const value_type& b){return a.key().compare(b.key()) < 0;});
+        auto it = std::unique(this->members_.rbegin(), this->members_.rend(),
+                              [](const value_type& a, const value_type& b){ return !(a.key().compare(b.key()));});
+        this->members_.erase(this->members_.begin(),it.base());
+    }
 };
 
 // Preserve order
@@ -1316,6 +2680,14 @@ public:
     {
     }
 
+    // Takes members in any order, as collected by basic_object_builder, and
+    // removes duplicate keys in one pass, the last member winning
+    json_object(object_storage_type&& members,const allocator_type& allocator)
+        : Json_object_<KeyT,Json>(std::move(members),allocator)
+    {
+        normalize_members_();
+    }
+
     json_object(std::initializer_list<typename Json::array> init)
         : Json_object_<KeyT,Json>()
     {
@@ -1447,9 +2819,7 @@ public:
         {
             this->members_.emplace_back(pred(*s));
         }
-        auto it = last_wins_unique_sequence(this->members_.begin(), this->members_.end(),
-                              [](const value_type& a, const value_type& b){ return a.key().compare(b.key());});
-        this->members_.erase(it,this->members_.end());
+        normalize_members_();
     }
 
     // insert_or_assign
@@ -1558,6 +2928,28 @@ public:
         return it;
     }
 
+    // erase_keys
+
+    // Erases the members with the given keys, in any order
+    template <class InputIt>
+    void erase_keys(InputIt first, InputIt last)
+    {
+        std::vector<string_view_type> keys;
+        for (; first != last; ++first)
+        {
+            keys.push_back(string_view_type(*first));
+        }
+        if (keys.empty())
+        {
+            return;
+        }
+        auto less = [](const string_view_type& a, const string_view_type& b){return a.compare(b) < 0;};
+        std::sort(keys.begin(), keys.end(), less);
+        auto it = std::remove_if(this->members_.begin(), this->members_.end(),
+                                 [&](const value_type& member){return std::binary_search(keys.begin(), keys.end(), member.key(), less);});
+        this->members_.erase(it, this->members_.end());
+    }
+
     // merge
 
     void merge(const json_object& source)
@@ -1869,6 +3261,98 @@ public:
     }
 private:
     json_object& operator=(const json_object&) = delete;
+
+    // Removes members with duplicate keys, the last of them winning
+    void normalize_members_()
+    {
+        auto it = last_wins_unique_sequence(this->members_.begin(), this->members_.end(),
+                              [](const value_type& a, const value_type& b){ return a.key().compare(b.key());});
+        this->members_.erase(it,this->members_.end());
+    }
+};
+
+
+// basic_object_builder
+
+// Collects the members of an object in any order and sorts them once when
+// the object is built, the last member with a duplicate key winning. This
+// costs O(n log n) for n members, where inserting them into an object one
+// at a time costs O(n^2) for a sorted object.
+
+template <class Json>
+class basic_object_builder
+{
+public:
+    typedef typename Json::allocator_type allocator_type;
+    typedef typename Json::string_view_type string_view_type;
+    typedef typename Json::key_storage_type key_storage_type;
+    typedef typename Json::key_value_pair_type value_type;
+    typedef typename Json::kvp_allocator_type kvp_allocator_type;
+    typedef typename Json::object_storage_type object_storage_type;
+    typedef typename Json::object object;
+
+    explicit basic_object_builder(const allocator_type& allocator = allocator_type())
+        : self_allocator_(allocator), members_(kvp_allocator_type(allocator))
+    {
+    }
+
+    allocator_type get_allocator() const
+    {
+        return self_allocator_;
+    }
+
+    size_t size() const
+    {
+        return members_.size();
+    }
+
+    bool empty() const
+    {
+        return members_.empty();
+    }
+
+    void reserve(size_t n)
+    {
+        members_.reserve(n);
+    }
+
+    void clear()
+    {
+        members_.clear();
+    }
+
+    void push_back(value_type&& member)
+    {
+        members_.push_back(std::move(member));
+    }
+
+    template <class T, class A=allocator_type>
+    typename std::enable_if<is_stateless<A>::value,void>::type
+    push_back(const string_view_type& name, T&& value)
+    {
+        members_.emplace_back(key_storage_type(name.begin(),name.end()), 
+                              std::forward<T>(value));
+    }
+
+    template <class T, class A=allocator_type>
+    typename std::enable_if<!is_stateless<A>::value,void>::type
+    push_back(const string_view_type& name, T&& value)
+    {
+        members_.emplace_back(key_storage_type(name.begin(),name.end(), get_allocator()), 
+                              std::forward<T>(value),get_allocator());
+    }
+
+    // Returns an object holding the members pushed so far, and leaves the
+    // builder empty
+    Json build()
+    {
+        object val(std::move(members_),self_allocator_);
+        members_ = object_storage_type(kvp_allocator_type(self_allocator_));
+        return Json(std::move(val));
+    }
+private:
+    allocator_type self_allocator_;
+    object_storage_type members_;
 };
 
 }
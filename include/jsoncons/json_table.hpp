@@ -0,0 +1,699 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_TABLE_HPP
+#define JSONCONS_JSON_TABLE_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <jsoncons/json.hpp>
+
+namespace jsoncons {
+
+// basic_json_table
+
+// An array of objects that all have the same member names, stored as the
+// member names once plus one column of values per name. Columns of int64,
+// uint64 or double values are kept in a packed_numeric_array, other columns
+// as a vector of values. The schema is taken from the first record. A record
+// with different member names, or a value that is not an object, converts
+// the table to an ordinary array of objects, which it keeps from then on.
+
+template <class Json>
+class basic_json_table
+{
+public:
+    typedef Json value_type;
+    typedef typename Json::allocator_type allocator_type;
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+
+    template <class TableT>
+    class row_proxy;
+
+    template <class TableT>
+    class row_iterator;
+
+    // A member of a row, its name and value
+    class row_member
+    {
+        string_view_type key_;
+        const Json* ref_;
+        Json value_;
+    public:
+        row_member(const string_view_type& key, const Json& ref)
+            : key_(key), ref_(std::addressof(ref))
+        {
+        }
+
+        row_member(const string_view_type& key, Json&& value)
+            : key_(key), ref_(nullptr), value_(std::move(value))
+        {
+        }
+
+        string_view_type key() const
+        {
+            return key_;
+        }
+
+        const Json& value() const
+        {
+            return ref_ != nullptr ? *ref_ : value_;
+        }
+    };
+
+    // Iterates over the members of a row, in the order of the schema, or of
+    // the object once the table has been converted. Values in columns are
+    // read as copies.
+    class member_iterator
+    {
+        const basic_json_table* table_;
+        size_t row_;
+        size_t k_;
+        typename Json::const_object_iterator it_;
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef row_member value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const row_member* pointer;
+        typedef row_member reference;
+
+        member_iterator(const basic_json_table* table, size_t row, size_t k, typename Json::const_object_iterator it)
+            : table_(table), row_(row), k_(k), it_(it)
+        {
+        }
+
+        row_member operator*() const
+        {
+            if (table_->columnar_)
+            {
+                const string_type& key = table_->keys_[k_];
+                return row_member(string_view_type(key.data(),key.length()),table_->columns_[k_].at(row_));
+            }
+            return row_member(it_->key(),it_->value());
+        }
+
+        member_iterator& operator++()
+        {
+            ++k_;
+            if (!table_->columnar_)
+            {
+                ++it_;
+            }
+            return *this;
+        }
+
+        member_iterator operator++(int)
+        {
+            member_iterator temp(*this);
+            ++(*this);
+            return temp;
+        }
+
+        bool operator==(const member_iterator& other) const
+        {
+            return k_ == other.k_;
+        }
+
+        bool operator!=(const member_iterator& other) const
+        {
+            return k_ != other.k_;
+        }
+    };
+
+    // A member of a row, read as a value and assigned through the table
+    template <class TableT>
+    class member_proxy
+    {
+        friend class row_proxy<TableT>;
+
+        TableT& table_;
+        size_t row_;
+        string_view_type name_;
+
+        member_proxy(TableT& table, size_t row, const string_view_type& name)
+            : table_(table), row_(row), name_(name)
+        {
+        }
+    public:
+        Json value() const
+        {
+            return table_.at(row_,name_);
+        }
+
+        operator Json() const
+        {
+            return value();
+        }
+
+        template <class T>
+        T as() const
+        {
+            return value().template as<T>();
+        }
+
+        template <class T>
+        member_proxy& operator=(T&& val)
+        {
+            table_.set(row_,name_,Json(std::forward<T>(val)));
+            return *this;
+        }
+    };
+
+    // A record of the table, with the read access of an object
+    template <class TableT>
+    class row_proxy
+    {
+        friend class basic_json_table;
+        friend class row_iterator<TableT>;
+
+        TableT& table_;
+        size_t row_;
+
+        row_proxy(TableT& table, size_t row)
+            : table_(table), row_(row)
+        {
+        }
+    public:
+        size_t size() const
+        {
+            return table_.row_size(row_);
+        }
+
+        bool has_key(const string_view_type& name) const
+        {
+            return table_.has_key(row_,name);
+        }
+
+        Json at(const string_view_type& name) const
+        {
+            return table_.at(row_,name);
+        }
+
+        member_proxy<TableT> operator[](const string_view_type& name) const
+        {
+            return member_proxy<TableT>(table_,row_,name);
+        }
+
+        range<member_iterator> object_range() const
+        {
+            return table_.row_members(row_);
+        }
+
+        Json to_json() const
+        {
+            return table_.row_to_json(row_);
+        }
+    };
+
+    // Iterates over the rows of a table, producing row proxies
+    template <class TableT>
+    class row_iterator
+    {
+        TableT* table_;
+        size_t row_;
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef row_proxy<TableT> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const row_proxy<TableT>* pointer;
+        typedef row_proxy<TableT> reference;
+
+        row_iterator(TableT* table, size_t row)
+            : table_(table), row_(row)
+        {
+        }
+
+        row_proxy<TableT> operator*() const
+        {
+            return row_proxy<TableT>(*table_,row_);
+        }
+
+        row_iterator& operator++()
+        {
+            ++row_;
+            return *this;
+        }
+
+        row_iterator operator++(int)
+        {
+            row_iterator temp(*this);
+            ++row_;
+            return temp;
+        }
+
+        bool operator==(const row_iterator& other) const
+        {
+            return row_ == other.row_;
+        }
+
+        bool operator!=(const row_iterator& other) const
+        {
+            return row_ != other.row_;
+        }
+    };
+
+    typedef row_proxy<basic_json_table> row_type;
+    typedef row_proxy<const basic_json_table> const_row_type;
+
+    explicit basic_json_table(const allocator_type& allocator = allocator_type())
+        : allocator_(allocator), rows_(typename Json::array(allocator)), size_(0), reserve_(0), columnar_(true)
+    {
+    }
+
+    explicit basic_json_table(const Json& records, const allocator_type& allocator = allocator_type())
+        : allocator_(allocator), rows_(typename Json::array(allocator)), size_(0), reserve_(0), columnar_(true)
+    {
+        if (!records.is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Attempting to make a table from a value that is not an array");
+        }
+        reserve(records.size());
+        for (const auto& record : records.array_range())
+        {
+            push_back(record);
+        }
+    }
+
+    // False once a record has broken the schema and the table holds an
+    // ordinary array of objects
+    bool is_columnar() const
+    {
+        return columnar_;
+    }
+
+    const std::vector<string_type>& keys() const
+    {
+        return keys_;
+    }
+
+    size_t size() const
+    {
+        return columnar_ ? size_ : rows_.size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    void reserve(size_t n)
+    {
+        reserve_ = n;
+        for (auto& col : columns_)
+        {
+            col.reserve(n);
+        }
+    }
+
+    void push_back(const Json& record)
+    {
+        if (columnar_)
+        {
+            if (size_ == 0 && keys_.empty() && record.is_object())
+            {
+                for (const auto& member : record.object_range())
+                {
+                    keys_.push_back(string_type(member.key().data(),member.key().length()));
+                    columns_.emplace_back(member.value(),allocator_);
+                    columns_.back().reserve(reserve_);
+                }
+            }
+            if (matches_schema(record))
+            {
+                size_t k = 0;
+                for (const auto& member : record.object_range())
+                {
+                    columns_[k++].push_back(member.value());
+                }
+                ++size_;
+                return;
+            }
+            convert_to_generic();
+        }
+        rows_.push_back(record);
+    }
+
+    row_type operator[](size_t i)
+    {
+        return row_type(*this,i);
+    }
+
+    const_row_type operator[](size_t i) const
+    {
+        return const_row_type(*this,i);
+    }
+
+    range<row_iterator<basic_json_table>> array_range()
+    {
+        return range<row_iterator<basic_json_table>>(row_iterator<basic_json_table>(this,0),
+                                                     row_iterator<basic_json_table>(this,size()));
+    }
+
+    range<row_iterator<const basic_json_table>> array_range() const
+    {
+        return range<row_iterator<const basic_json_table>>(row_iterator<const basic_json_table>(this,0),
+                                                           row_iterator<const basic_json_table>(this,size()));
+    }
+
+    // The members of row i. Throws std::out_of_range if there is no row i,
+    // and std::runtime_error if a converted table holds a value at i that
+    // is not an object.
+    range<member_iterator> row_members(size_t i) const
+    {
+        check_row(i);
+        if (columnar_)
+        {
+            return range<member_iterator>(member_iterator(this,i,0,typename Json::const_object_iterator()),
+                                          member_iterator(this,i,keys_.size(),typename Json::const_object_iterator()));
+        }
+        auto members = rows_[i].object_range();
+        return range<member_iterator>(member_iterator(this,i,0,members.begin()),
+                                      member_iterator(this,i,rows_[i].size(),members.end()));
+    }
+
+    // The functions that take a row position throw std::out_of_range if
+    // there is no row at that position
+
+    size_t row_size(size_t i) const
+    {
+        check_row(i);
+        return columnar_ ? keys_.size() : rows_[i].size();
+    }
+
+    bool has_key(size_t i, const string_view_type& name) const
+    {
+        check_row(i);
+        return columnar_ ? find_column(name) < keys_.size() : rows_[i].has_key(name);
+    }
+
+    Json at(size_t i, const string_view_type& name) const
+    {
+        check_row(i);
+        if (!columnar_)
+        {
+            return rows_[i].at(name);
+        }
+        size_t k = find_column(name);
+        if (k == keys_.size())
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::out_of_range,"%s not found",view_to_string(name));
+        }
+        return columns_[k].at(i);
+    }
+
+    // Assigns a member of a row. Assigning a member that is not in the
+    // schema converts the table to an array of objects.
+    void set(size_t i, const string_view_type& name, const Json& val)
+    {
+        check_row(i);
+        if (columnar_)
+        {
+            size_t k = find_column(name);
+            if (k < keys_.size())
+            {
+                columns_[k].set(i,val);
+                return;
+            }
+            convert_to_generic();
+        }
+        rows_[i].insert_or_assign(name,val);
+    }
+
+    Json row_to_json(size_t i) const
+    {
+        check_row(i);
+        if (!columnar_)
+        {
+            return rows_[i];
+        }
+        typename Json::object_builder builder(allocator_);
+        builder.reserve(keys_.size());
+        for (size_t k = 0; k < keys_.size(); ++k)
+        {
+            builder.push_back(keys_[k],columns_[k].at(i));
+        }
+        return builder.build();
+    }
+
+    // The records as an array of objects
+    Json to_json() const
+    {
+        if (!columnar_)
+        {
+            return rows_;
+        }
+        Json result = typename Json::array(allocator_);
+        result.reserve(size_);
+        for (size_t i = 0; i < size_; ++i)
+        {
+            result.push_back(row_to_json(i));
+        }
+        return result;
+    }
+
+    // Calls f(i, value) with the member name of each record that has one,
+    // converted to T. Packed columns are read without making values.
+    template <class T, class F>
+    void scan(const string_view_type& name, F f) const
+    {
+        if (columnar_)
+        {
+            size_t k = find_column(name);
+            if (k < keys_.size())
+            {
+                columns_[k].template scan<T>(size_,f);
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < rows_.size(); ++i)
+            {
+                const Json& row = rows_[i];
+                if (row.is_object())
+                {
+                    auto it = row.find(name);
+                    if (it != row.object_range().end())
+                    {
+                        f(i,it->value().template as<T>());
+                    }
+                }
+            }
+        }
+    }
+
+    // Positions of the records whose member name, converted to T, satisfies pred
+    template <class T, class Pred>
+    std::vector<size_t> filter(const string_view_type& name, Pred pred) const
+    {
+        std::vector<size_t> result;
+        scan<T>(name,[&](size_t i, const T& val)
+        {
+            if (pred(val))
+            {
+                result.push_back(i);
+            }
+        });
+        return result;
+    }
+
+    template <class T>
+    T sum(const string_view_type& name) const
+    {
+        T result = T();
+        scan<T>(name,[&](size_t, const T& val){result += val;});
+        return result;
+    }
+
+    json_memory_footprint memory_footprint() const
+    {
+        if (!columnar_)
+        {
+            return rows_.memory_footprint();
+        }
+        json_memory_footprint footprint;
+        for (const auto& key : keys_)
+        {
+            footprint.key_bytes += detail::heap_capacity_bytes(key,1);
+        }
+        footprint.array_bytes += detail::heap_capacity_bytes(keys_) + detail::heap_capacity_bytes(columns_);
+        for (const auto& col : columns_)
+        {
+            footprint += col.memory_footprint();
+        }
+        return footprint;
+    }
+private:
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<Json> value_allocator_type;
+
+    class column
+    {
+    public:
+        column(const Json& first, const allocator_type& allocator)
+            : packed_(is_packable(first) ? first.type_id() : json_type_tag::integer_t, allocator),
+              values_(value_allocator_type(allocator)),
+              is_packed_(is_packable(first))
+        {
+        }
+
+        void reserve(size_t n)
+        {
+            if (is_packed_)
+            {
+                packed_.reserve(n);
+            }
+            else
+            {
+                values_.reserve(n);
+            }
+        }
+
+        void push_back(const Json& val)
+        {
+            if (!(is_packed_ && packed_.try_push_back(val)))
+            {
+                unpack();
+                values_.push_back(val);
+            }
+        }
+
+        void set(size_t i, const Json& val)
+        {
+            if (!(is_packed_ && packed_.try_set(i,val)))
+            {
+                unpack();
+                values_[i] = val;
+            }
+        }
+
+        Json at(size_t i) const
+        {
+            return is_packed_ ? packed_.template at<Json>(i) : values_[i];
+        }
+
+        template <class T, class F>
+        void scan(size_t size, F& f) const
+        {
+            if (is_packed_)
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    f(i,packed_.template value_at<T>(i));
+                }
+            }
+            else
+            {
+                for (size_t i = 0; i < size; ++i)
+                {
+                    f(i,values_[i].template as<T>());
+                }
+            }
+        }
+
+        json_memory_footprint memory_footprint() const
+        {
+            json_memory_footprint footprint;
+            footprint.array_bytes += packed_.heap_bytes() + detail::heap_capacity_bytes(values_);
+            for (const auto& val : values_)
+            {
+                footprint += val.memory_footprint();
+            }
+            return footprint;
+        }
+    private:
+        packed_numeric_array<allocator_type> packed_;
+        std::vector<Json,value_allocator_type> values_;
+        bool is_packed_;
+
+        static bool is_packable(const Json& val)
+        {
+            return val.type_id() == json_type_tag::integer_t || val.type_id() == json_type_tag::uinteger_t || val.type_id() == json_type_tag::double_t;
+        }
+
+        // A value of another type was stored, keep the column as values
+        void unpack()
+        {
+            if (is_packed_)
+            {
+                values_.reserve(packed_.capacity());
+                for (size_t i = 0; i < packed_.size(); ++i)
+                {
+                    values_.push_back(packed_.template at<Json>(i));
+                }
+                packed_.clear();
+                packed_.shrink_to_fit();
+                is_packed_ = false;
+            }
+        }
+    };
+
+    allocator_type allocator_;
+    std::vector<string_type> keys_;
+    std::vector<column> columns_;
+    Json rows_;
+    size_t size_;
+    size_t reserve_;
+    bool columnar_;
+
+    void check_row(size_t i) const
+    {
+        if (i >= size())
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+        }
+    }
+
+    size_t find_column(const string_view_type& name) const
+    {
+        size_t k = 0;
+        while (k < keys_.size() && !(string_view_type(keys_[k].data(),keys_[k].length()) == name))
+        {
+            ++k;
+        }
+        return k;
+    }
+
+    bool matches_schema(const Json& record) const
+    {
+        if (!record.is_object() || record.size() != keys_.size())
+        {
+            return false;
+        }
+        size_t k = 0;
+        for (const auto& member : record.object_range())
+        {
+            if (!(member.key() == string_view_type(keys_[k].data(),keys_[k].length())))
+            {
+                return false;
+            }
+            ++k;
+        }
+        return true;
+    }
+
+    void convert_to_generic()
+    {
+        Json rows = to_json();
+        rows_.swap(rows);
+        keys_.clear();
+        columns_.clear();
+        size_ = 0;
+        columnar_ = false;
+    }
+};
+
+typedef basic_json_table<json> json_table;
+typedef basic_json_table<ojson> ojson_table;
+typedef basic_json_table<wjson> wjson_table;
+typedef basic_json_table<wojson> wojson_table;
+
+}
+
+#endif
@@ -175,6 +175,49 @@ private:
     base_iterator it_;
 };
 
+// packed_array_as
+
+template <class T>
+struct is_std_vector : std::false_type {};
+
+template <class E, class A>
+struct is_std_vector<std::vector<E,A>> : std::true_type {};
+
+template <class T, class PackedArray>
+typename std::enable_if<is_std_vector<T>::value,T>::type
+packed_array_as(const PackedArray& packed)
+{
+    typedef typename T::value_type element_type;
+
+    T v(packed.size());
+    if (packed.template has_representation<element_type>())
+    {
+        packed.copy_to(v.data());
+    }
+    else
+    {
+        for (size_t i = 0; i < packed.size(); ++i)
+        {
+            v[i] = packed.template value_at<element_type>(i);
+        }
+    }
+    return v;
+}
+
+template <class T, class PackedArray>
+typename std::enable_if<!is_std_vector<T>::value,T>::type
+packed_array_as(const PackedArray& packed)
+{
+    typedef typename std::iterator_traits<typename T::iterator>::value_type element_type;
+
+    T v;
+    for (size_t i = 0; i < packed.size(); ++i)
+    {
+        v.insert(v.end(), packed.template value_at<element_type>(i));
+    }
+    return v;
+}
+
 template <class Json, class T>
 class json_object_input_iterator
 {
@@ -558,9 +601,7 @@ struct json_type_traits<Json, T,
     {
         if (j.is_array())
         {
-            T v(detail::json_array_input_iterator<Json, element_type>(j.array_range().begin()),
-                detail::json_array_input_iterator<Json, element_type>(j.array_range().end()));
-            return v;
+            return as_array(j);
         }
         else
         {
@@ -574,9 +615,7 @@ struct json_type_traits<Json, T,
     {
         if (j.is_array())
         {
-            T v(detail::json_array_input_iterator<Json, element_type>(j.array_range().begin()),
-                detail::json_array_input_iterator<Json, element_type>(j.array_range().end()));
-            return v;
+            return as_array(j);
         }
         else if (j.is_byte_string())
         {
@@ -589,6 +628,28 @@ struct json_type_traits<Json, T,
         }
     }
 
+    template <class Ty = element_type>
+    static typename std::enable_if<!(std::is_arithmetic<Ty>::value && !std::is_same<Ty,bool>::value),T>::type
+    as_array(const Json& j)
+    {
+        T v(detail::json_array_input_iterator<Json, element_type>(j.array_range().begin()),
+            detail::json_array_input_iterator<Json, element_type>(j.array_range().end()));
+        return v;
+    }
+
+    template <class Ty = element_type>
+    static typename std::enable_if<std::is_arithmetic<Ty>::value && !std::is_same<Ty,bool>::value,T>::type
+    as_array(const Json& j)
+    {
+        if (j.array_value().is_packed())
+        {
+            return detail::packed_array_as<T>(j.array_value().packed());
+        }
+        T v(detail::json_array_input_iterator<Json, element_type>(j.array_range().begin()),
+            detail::json_array_input_iterator<Json, element_type>(j.array_range().end()));
+        return v;
+    }
+
     static Json to_json(const T& val)
     {
         Json j = typename Json::array();
@@ -0,0 +1,533 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_LAZY_JSON_HPP
+#define JSONCONS_LAZY_JSON_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <jsoncons/json.hpp>
+
+namespace jsoncons {
+
+// basic_lazy_json
+
+// A read only view of a JSON text that parses only what is accessed.
+// Parsing the text finds the extent of the root value by skipping over it,
+// without building values. The first access to a member or element of an
+// object or array records the extents of its children in one pass over
+// that level, skipping nested values. A value is parsed into a Json by
+// value(), as<T>() and the is_xxx() tests that need the type of a number,
+// and kept. Copies are handles to the same node and share what has been
+// recorded and parsed.
+//
+// The text is checked only as far as it is read: a malformed subtree that is
+// never accessed is not reported.
+//
+// Reading records and parses into the nodes without synchronization, so a
+// value and the copies that share its nodes must not be read from several
+// threads at once. A default constructed or moved from value has no text,
+// and its accessors throw std::runtime_error.
+
+template <class Json>
+class basic_lazy_json
+{
+public:
+    typedef Json value_type;
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+
+    struct member_type;
+
+    basic_lazy_json()
+    {
+    }
+
+    // Copies the text, which the nodes refer to
+    static basic_lazy_json parse(const string_view_type& s)
+    {
+        return parse_text(std::make_shared<const string_type>(s.data(),s.length()));
+    }
+
+    // The text of the value
+    string_view_type raw() const
+    {
+        const node& n = get_node();
+        return string_view_type(n.first,n.last - n.first);
+    }
+
+    bool is_object() const
+    {
+        return first_char() == '{';
+    }
+
+    bool is_array() const
+    {
+        return first_char() == '[';
+    }
+
+    bool is_string() const
+    {
+        return first_char() == '\"';
+    }
+
+    bool is_null() const
+    {
+        return first_char() == 'n';
+    }
+
+    bool is_bool() const
+    {
+        char_type c = first_char();
+        return c == 't' || c == 'f';
+    }
+
+    bool is_number() const
+    {
+        char_type c = first_char();
+        return c == '-' || (c >= '0' && c <= '9');
+    }
+
+    // The number of members or elements, zero for other values
+    size_t size() const
+    {
+        if (is_object())
+        {
+            return members().size();
+        }
+        else if (is_array())
+        {
+            return elements().size();
+        }
+        return 0;
+    }
+
+    // The members of an object in document order
+    const std::vector<member_type>& members() const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
+        }
+        if (!node_->is_indexed)
+        {
+            index_members();
+        }
+        return node_->members;
+    }
+
+    // The elements of an array
+    const std::vector<basic_lazy_json>& elements() const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an array");
+        }
+        if (!node_->is_indexed)
+        {
+            index_elements();
+        }
+        return node_->elements;
+    }
+
+    bool has_key(const string_view_type& name) const
+    {
+        return is_object() && find(name) != nullptr;
+    }
+
+    // The value of member name. If the object has the name more than once,
+    // the last one, as when parsed into a Json.
+    basic_lazy_json at(const string_view_type& name) const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::runtime_error,"Attempting to get %s from a value that is not an object", view_to_string(name));
+        }
+        const basic_lazy_json* val = find(name);
+        if (val == nullptr)
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::out_of_range,"%s not found", view_to_string(name));
+        }
+        return *val;
+    }
+
+    basic_lazy_json at(size_t i) const
+    {
+        const std::vector<basic_lazy_json>& elems = elements();
+        if (i >= elems.size())
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+        }
+        return elems[i];
+    }
+
+    basic_lazy_json operator[](const string_view_type& name) const
+    {
+        return at(name);
+    }
+
+    basic_lazy_json operator[](size_t i) const
+    {
+        return at(i);
+    }
+
+    // The value parsed into a Json, on the first call
+    const Json& value() const
+    {
+        node& n = get_node();
+        if (!n.value)
+        {
+            try
+            {
+                n.value.reset(new Json(Json::parse(raw())));
+            }
+            catch (const parse_error& e)
+            {
+                std::pair<size_t,size_t> pos = position(*n.text,n.first);
+                size_t line = e.line_number() + pos.first - 1;
+                size_t column = e.line_number() == 1 ? e.column_number() + pos.second - 1 : e.column_number();
+                throw parse_error(e.code(),line,column);
+            }
+        }
+        return *n.value;
+    }
+
+    bool is_parsed() const
+    {
+        return get_node().value != nullptr;
+    }
+
+    template <class T>
+    T as() const
+    {
+        return value().template as<T>();
+    }
+
+    template <class T>
+    bool is() const
+    {
+        return value().template is<T>();
+    }
+private:
+    struct node
+    {
+        std::shared_ptr<const string_type> text;
+        const char_type* first;
+        const char_type* last;
+        bool is_indexed;
+        std::vector<member_type> members;
+        std::vector<size_t> sorted_members;
+        std::vector<basic_lazy_json> elements;
+        std::unique_ptr<Json> value;
+
+        node(const std::shared_ptr<const string_type>& text, const char_type* first, const char_type* last)
+            : text(text), first(first), last(last), is_indexed(false)
+        {
+        }
+    };
+
+    std::shared_ptr<node> node_;
+
+    explicit basic_lazy_json(std::shared_ptr<node> n)
+        : node_(std::move(n))
+    {
+    }
+
+    node& get_node() const
+    {
+        if (!node_)
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Accessing a lazy_json that has no text");
+        }
+        return *node_;
+    }
+
+    char_type first_char() const
+    {
+        return *get_node().first;
+    }
+
+    static basic_lazy_json parse_text(const std::shared_ptr<const string_type>& text)
+    {
+        const char_type* first = text->data();
+        const char_type* last = text->data() + text->length();
+
+        auto result = unicons::skip_bom(first, last);
+        if (result.ec != unicons::encoding_errc())
+        {
+            throw parse_error(result.ec,1,1);
+        }
+        const char_type* p = skip_whitespace(result.it,last);
+        if (p == last)
+        {
+            throw_error(*text,p,json_parser_errc::unexpected_eof);
+        }
+        const char_type* end = skip_value(*text,p,last);
+        if (skip_whitespace(end,last) != last)
+        {
+            throw_error(*text,skip_whitespace(end,last),json_parser_errc::extra_character);
+        }
+        return basic_lazy_json(std::make_shared<node>(text,p,end));
+    }
+
+    basic_lazy_json make_child(const char_type* first, const char_type* last) const
+    {
+        return basic_lazy_json(std::make_shared<node>(node_->text,first,last));
+    }
+
+    const basic_lazy_json* find(const string_view_type& name) const
+    {
+        const std::vector<member_type>& mems = members();
+        const std::vector<size_t>& sorted = node_->sorted_members;
+        auto it = std::upper_bound(sorted.begin(),sorted.end(),name,
+                                   [&](const string_view_type& a, size_t b){return a < string_view_type(mems[b].key.data(),mems[b].key.length());});
+        if (it == sorted.begin())
+        {
+            return nullptr;
+        }
+        const member_type& member = mems[*(it-1)];
+        return string_view_type(member.key.data(),member.key.length()) == name ? std::addressof(member.value) : nullptr;
+    }
+
+    void index_members() const
+    {
+        const string_type& text = *node_->text;
+        const char_type* last = node_->last;
+        const char_type* p = skip_whitespace(node_->first + 1,last);
+        if (p != last && *p != '}')
+        {
+            while (true)
+            {
+                if (p == last || *p != '\"')
+                {
+                    throw_error(text,p,json_parser_errc::expected_name);
+                }
+                const char_type* key_end = skip_string(text,p,last);
+                string_type key = decode_key(p,key_end);
+                p = skip_whitespace(key_end,last);
+                if (p == last || *p != ':')
+                {
+                    throw_error(text,p,json_parser_errc::expected_colon);
+                }
+                p = skip_whitespace(p + 1,last);
+                const char_type* value_end = skip_value(text,p,last);
+                node_->members.push_back(member_type{std::move(key),make_child(p,value_end)});
+                p = skip_whitespace(value_end,last);
+                if (p == last)
+                {
+                    throw_error(text,p,json_parser_errc::unexpected_eof);
+                }
+                else if (*p == ',')
+                {
+                    p = skip_whitespace(p + 1,last);
+                }
+                else if (*p == '}')
+                {
+                    break;
+                }
+                else
+                {
+                    throw_error(text,p,json_parser_errc::expected_comma_or_right_brace);
+                }
+            }
+        }
+        const std::vector<member_type>& mems = node_->members;
+        std::vector<size_t>& sorted = node_->sorted_members;
+        sorted.reserve(mems.size());
+        for (size_t i = 0; i < mems.size(); ++i)
+        {
+            sorted.push_back(i);
+        }
+        std::stable_sort(sorted.begin(),sorted.end(),
+                         [&](size_t a, size_t b){return mems[a].key < mems[b].key;});
+        node_->is_indexed = true;
+    }
+
+    void index_elements() const
+    {
+        const string_type& text = *node_->text;
+        const char_type* last = node_->last;
+        const char_type* p = skip_whitespace(node_->first + 1,last);
+        if (p != last && *p != ']')
+        {
+            while (true)
+            {
+                const char_type* value_end = skip_value(text,p,last);
+                node_->elements.push_back(make_child(p,value_end));
+                p = skip_whitespace(value_end,last);
+                if (p == last)
+                {
+                    throw_error(text,p,json_parser_errc::unexpected_eof);
+                }
+                else if (*p == ',')
+                {
+                    p = skip_whitespace(p + 1,last);
+                }
+                else if (*p == ']')
+                {
+                    break;
+                }
+                else
+                {
+                    throw_error(text,p,json_parser_errc::expected_comma_or_right_bracket);
+                }
+            }
+        }
+        node_->is_indexed = true;
+    }
+
+    // A key without escapes is copied, others are decoded by the parser
+    static string_type decode_key(const char_type* first, const char_type* last)
+    {
+        if (std::find(first,last,'\\') == last)
+        {
+            return string_type(first + 1,last - 1);
+        }
+        Json key = Json::parse(string_view_type(first,last - first));
+        string_view_type sv = key.as_string_view();
+        return string_type(sv.data(),sv.length());
+    }
+
+    static const char_type* skip_whitespace(const char_type* p, const char_type* last)
+    {
+        while (p != last && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    // p is at the opening quote, returns the position after the closing quote
+    static const char_type* skip_string(const string_type& text, const char_type* p, const char_type* last)
+    {
+        ++p;
+        while (p != last)
+        {
+            if (*p == '\"')
+            {
+                return p + 1;
+            }
+            if (*p == '\\')
+            {
+                ++p;
+                if (p == last)
+                {
+                    break;
+                }
+            }
+            ++p;
+        }
+        throw_error(text,last,json_parser_errc::unexpected_eof);
+        return last;
+    }
+
+    // Returns the position after the value at p, skipping nested objects
+    // and arrays by counting brackets outside of strings
+    static const char_type* skip_value(const string_type& text, const char_type* p, const char_type* last)
+    {
+        if (p == last)
+        {
+            throw_error(text,p,json_parser_errc::unexpected_eof);
+        }
+        switch (*p)
+        {
+        case '{':
+        case '[':
+            {
+                size_t depth = 0;
+                while (p != last)
+                {
+                    switch (*p)
+                    {
+                    case '{':
+                    case '[':
+                        ++depth;
+                        ++p;
+                        break;
+                    case '}':
+                    case ']':
+                        ++p;
+                        if (--depth == 0)
+                        {
+                            return p;
+                        }
+                        break;
+                    case '\"':
+                        p = skip_string(text,p,last);
+                        break;
+                    default:
+                        ++p;
+                        break;
+                    }
+                }
+                throw_error(text,last,json_parser_errc::unexpected_eof);
+                return last;
+            }
+        case '\"':
+            return skip_string(text,p,last);
+        case '}':
+            throw_error(text,p,json_parser_errc::unexpected_right_brace);
+            return last;
+        case ']':
+            throw_error(text,p,json_parser_errc::unexpected_right_bracket);
+            return last;
+        case ',':
+        case ':':
+            throw_error(text,p,json_parser_errc::expected_value);
+            return last;
+        default:
+            while (p != last && *p != ',' && *p != '}' && *p != ']' && *p != ':'
+                   && *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r')
+            {
+                ++p;
+            }
+            return p;
+        }
+    }
+
+    // One based line and column of p
+    static std::pair<size_t,size_t> position(const string_type& text, const char_type* p)
+    {
+        size_t line = 1;
+        const char_type* line_start = text.data();
+        for (const char_type* q = text.data(); q != p; ++q)
+        {
+            if (*q == '\n')
+            {
+                ++line;
+                line_start = q + 1;
+            }
+        }
+        return std::make_pair(line,static_cast<size_t>(p - line_start) + 1);
+    }
+
+    static void throw_error(const string_type& text, const char_type* p, json_parser_errc ec)
+    {
+        std::pair<size_t,size_t> pos = position(text,p);
+        throw parse_error(make_error_code(ec),pos.first,pos.second);
+    }
+};
+
+template <class Json>
+struct basic_lazy_json<Json>::member_type
+{
+    string_type key;
+    basic_lazy_json value;
+};
+
+typedef basic_lazy_json<json> lazy_json;
+typedef basic_lazy_json<ojson> lazy_ojson;
+typedef basic_lazy_json<wjson> wlazy_json;
+typedef basic_lazy_json<wojson> wlazy_ojson;
+
+}
+
+#endif
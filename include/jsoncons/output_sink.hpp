@@ -0,0 +1,507 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_OUTPUT_SINK_HPP
+#define JSONCONS_OUTPUT_SINK_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cerrno>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/uio.h>
+#include <climits>
+#endif
+#include <jsoncons/json_exception.hpp>
+
+namespace jsoncons {
+
+// basic_output_sink
+
+// Where buffered_output sends its characters. The sink owns the buffer that
+// buffered_output writes into: next_buffer hands out a region, and the next
+// call to next_buffer or flush says how many characters of that region were
+// written. A sink may pass characters on whenever it is given them, but must
+// have passed on everything given to it when flush returns.
+
+template <class CharT>
+class basic_output_sink
+{
+public:
+    typedef CharT char_type;
+
+    virtual ~basic_output_sink() {}
+
+    // Takes the first count characters of the region returned by the previous
+    // call (count is zero on the first call and after a flush), and returns a
+    // region of at least min_length characters, whose length is set in length
+    virtual CharT* next_buffer(size_t count, size_t min_length, size_t& length) = 0;
+
+    // Takes the first count characters of the region returned by the previous
+    // call to next_buffer, and passes on everything taken so far
+    virtual void flush(size_t count) = 0;
+
+    // The length from which write_reference may be called for a run of
+    // characters, or zero if the sink takes only copies
+    virtual size_t min_reference_length() const
+    {
+        return 0;
+    }
+
+    // Takes the first count characters of the region returned by the previous
+    // call to next_buffer, followed by the length characters at s, which stay
+    // unchanged until the next flush. Returns false, having taken nothing, if
+    // the characters at s are to be copied instead.
+    virtual bool write_reference(size_t count, const CharT* s, size_t length)
+    {
+        (void)count; (void)s; (void)length;
+        return false;
+    }
+};
+
+// basic_ostream_sink
+
+// Buffers characters and writes them to an output stream
+
+template <class CharT>
+class basic_ostream_sink : public basic_output_sink<CharT>
+{
+public:
+    static const size_t default_buffer_length = 16384;
+
+    basic_ostream_sink(std::basic_ostream<CharT>& os, size_t buflen = default_buffer_length)
+        : os_(std::addressof(os)), buffer_(buflen)
+    {
+    }
+
+    // Writes to os from now on, keeping the buffer. Characters not yet
+    // flushed are written to os.
+    void reset(std::basic_ostream<CharT>& os)
+    {
+        os_ = std::addressof(os);
+    }
+
+    CharT* next_buffer(size_t count, size_t min_length, size_t& length) override
+    {
+        os_->write(buffer_.data(), count);
+        if (buffer_.size() < min_length)
+        {
+            buffer_.resize(min_length);
+        }
+        length = buffer_.size();
+        return buffer_.data();
+    }
+
+    void flush(size_t count) override
+    {
+        os_->write(buffer_.data(), count);
+        os_->flush();
+    }
+private:
+    std::basic_ostream<CharT>* os_;
+    std::vector<CharT> buffer_;
+};
+
+template <class CharT>
+const size_t basic_ostream_sink<CharT>::default_buffer_length;
+
+// basic_string_sink
+
+// Appends characters to a string, writing them directly into its storage
+
+template <class CharT,class Traits=std::char_traits<CharT>,class Allocator=std::allocator<CharT>>
+class basic_string_sink : public basic_output_sink<CharT>
+{
+public:
+    typedef std::basic_string<CharT,Traits,Allocator> string_type;
+
+    explicit basic_string_sink(string_type& s)
+        : s_(s), length_(s.length())
+    {
+    }
+
+    CharT* next_buffer(size_t count, size_t min_length, size_t& length) override
+    {
+        length_ += count;
+        const size_t new_length = length_ + (std::max)(min_length, (std::max)(length_, min_growth));
+        s_.resize((std::max)(new_length, s_.capacity()));
+        length = s_.length() - length_;
+        return &s_[0] + length_;
+    }
+
+    void flush(size_t count) override
+    {
+        length_ += count;
+        s_.resize(length_);
+    }
+private:
+    static const size_t min_growth = 64;
+
+    string_type& s_;
+    size_t length_;
+};
+
+template <class CharT,class Traits,class Allocator>
+const size_t basic_string_sink<CharT,Traits,Allocator>::min_growth;
+
+// basic_fixed_buffer_sink
+
+// Writes characters to a buffer provided by the caller. Output that does not
+// fit is counted but discarded, so that after an overflow the buffer holds as
+// much of the output as fitted, and required_size() is the length that
+// would have held it all.
+
+template <class CharT>
+class basic_fixed_buffer_sink : public basic_output_sink<CharT>
+{
+public:
+    basic_fixed_buffer_sink(CharT* data, size_t capacity)
+        : data_(data), capacity_(capacity), size_(0), discarded_(0), overflow_(false)
+    {
+    }
+
+    CharT* data() const
+    {
+        return data_;
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    // The number of characters written to the buffer
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool overflow() const
+    {
+        return overflow_;
+    }
+
+    size_t required_size() const
+    {
+        return size_ + discarded_;
+    }
+
+    CharT* next_buffer(size_t count, size_t min_length, size_t& length) override
+    {
+        take(count);
+        if (!overflow_ && capacity_ - size_ >= min_length)
+        {
+            length = capacity_ - size_;
+            return data_ + size_;
+        }
+        overflow_ = true;
+        if (scratch_.size() < (std::max)(min_length, min_scratch_length))
+        {
+            scratch_.resize((std::max)(min_length, min_scratch_length));
+        }
+        length = scratch_.size();
+        return scratch_.data();
+    }
+
+    void flush(size_t count) override
+    {
+        take(count);
+    }
+private:
+    static const size_t min_scratch_length = 256;
+
+    CharT* data_;
+    size_t capacity_;
+    size_t size_;
+    size_t discarded_;
+    bool overflow_;
+    std::vector<CharT> scratch_;
+
+    void take(size_t count)
+    {
+        if (overflow_)
+        {
+            discarded_ += count;
+        }
+        else
+        {
+            size_ += count;
+        }
+    }
+};
+
+template <class CharT>
+const size_t basic_fixed_buffer_sink<CharT>::min_scratch_length;
+
+// basic_counting_sink
+
+// Counts the characters of the output and discards them
+
+template <class CharT>
+class basic_counting_sink : public basic_output_sink<CharT>
+{
+public:
+    basic_counting_sink()
+        : count_(0)
+    {
+    }
+
+    size_t count() const
+    {
+        return count_;
+    }
+
+    CharT* next_buffer(size_t count, size_t min_length, size_t& length) override
+    {
+        count_ += count;
+        if (min_length <= buffer_length)
+        {
+            length = buffer_length;
+            return buffer_;
+        }
+        overflow_buffer_.resize(min_length);
+        length = min_length;
+        return overflow_buffer_.data();
+    }
+
+    void flush(size_t count) override
+    {
+        count_ += count;
+    }
+private:
+    static const size_t buffer_length = 1024;
+
+    size_t count_;
+    CharT buffer_[buffer_length];
+    std::vector<CharT> overflow_buffer_;
+};
+
+template <class CharT>
+const size_t basic_counting_sink<CharT>::buffer_length;
+
+// basic_fd_sink
+
+// Buffers characters and writes them to a file descriptor, which it does
+// not close. Given a min_reference_length, runs of at least that many
+// characters that need no escaping in string values and member names are
+// not copied into the buffer: the sink keeps references to them, and writes
+// them together with the buffered characters around them in one writev
+// call. The serializer passes runs by reference only if told that its
+// strings stay unchanged until it flushes, as dump does.
+
+template <class CharT>
+class basic_fd_sink : public basic_output_sink<CharT>
+{
+public:
+    static const size_t default_buffer_length = 16384;
+
+    explicit basic_fd_sink(int fd, size_t buflen = default_buffer_length, size_t min_reference_length = 0)
+        : fd_(fd), buffer_(buflen), min_reference_length_(min_reference_length), used_(0)
+    {
+    }
+
+    int fd() const
+    {
+        return fd_;
+    }
+
+    CharT* next_buffer(size_t count, size_t min_length, size_t& length) override
+    {
+        if (segments_.empty())
+        {
+            write_all(buffer_.data(), count);
+        }
+        else
+        {
+            // Keep the characters written since the last reference, and
+            // hand out the rest of the buffer if enough of it is left
+            take(count);
+            if (buffer_.size() - used_ < (std::max)(min_length, buffer_.size()/4))
+            {
+                write_segments();
+            }
+        }
+        if (buffer_.size() - used_ < min_length)
+        {
+            buffer_.resize(used_ + min_length);
+        }
+        length = buffer_.size() - used_;
+        return buffer_.data() + used_;
+    }
+
+    void flush(size_t count) override
+    {
+        if (segments_.empty())
+        {
+            write_all(buffer_.data(), count);
+        }
+        else
+        {
+            take(count);
+            write_segments();
+        }
+    }
+
+    size_t min_reference_length() const override
+    {
+        return min_reference_length_;
+    }
+
+    bool write_reference(size_t count, const CharT* s, size_t length) override
+    {
+        take(count);
+        segments_.push_back(segment(s, length));
+        if (segments_.size() >= max_segments)
+        {
+            write_segments();
+        }
+        return true;
+    }
+private:
+    static const size_t max_segments = 64;
+
+    struct segment
+    {
+        segment(const CharT* data, size_t length)
+            : data(data), length(length)
+        {
+        }
+
+        const CharT* data;
+        size_t length;
+    };
+
+    int fd_;
+    std::vector<CharT> buffer_;
+    size_t min_reference_length_;
+    // The length of the front of the buffer held in segments_
+    size_t used_;
+    std::vector<segment> segments_;
+
+    void take(size_t count)
+    {
+        if (count > 0)
+        {
+            segments_.push_back(segment(buffer_.data() + used_, count));
+            used_ += count;
+        }
+    }
+
+    void write_segments()
+    {
+#if defined(_WIN32)
+        for (const auto& seg : segments_)
+        {
+            write_all(seg.data, seg.length);
+        }
+#else
+#if defined(IOV_MAX)
+        const size_t iov_max = IOV_MAX;
+#else
+        const size_t iov_max = 16;
+#endif
+        struct iovec iov[max_segments];
+        size_t first = 0;
+        while (first < segments_.size())
+        {
+            const size_t n = (std::min)((std::min)(segments_.size() - first, iov_max), max_segments);
+            for (size_t i = 0; i < n; ++i)
+            {
+                iov[i].iov_base = const_cast<CharT*>(segments_[first + i].data);
+                iov[i].iov_len = segments_[first + i].length*sizeof(CharT);
+            }
+            writev_all(iov, n);
+            first += n;
+        }
+#endif
+        segments_.clear();
+        used_ = 0;
+    }
+
+#if !defined(_WIN32)
+    void writev_all(struct iovec* iov, size_t n)
+    {
+        while (n > 0)
+        {
+            ssize_t written = ::writev(fd_, iov, static_cast<int>(n));
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Error writing to file descriptor");
+            }
+            // Skip what was written, which may end part way through a segment
+            size_t remaining = static_cast<size_t>(written);
+            while (n > 0 && remaining >= iov->iov_len)
+            {
+                remaining -= iov->iov_len;
+                ++iov;
+                --n;
+            }
+            if (n > 0)
+            {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+                iov->iov_len -= remaining;
+            }
+        }
+    }
+#endif
+
+    void write_all(const CharT* data, size_t count)
+    {
+        const char* p = reinterpret_cast<const char*>(data);
+        size_t remaining = count*sizeof(CharT);
+        while (remaining > 0)
+        {
+#if defined(_WIN32)
+            const int n = ::_write(fd_, p, static_cast<unsigned int>((std::min)(remaining, size_t(1) << 30)));
+#else
+            const ssize_t n = ::write(fd_, p, remaining);
+#endif
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                JSONCONS_THROW_EXCEPTION(std::runtime_error,"Error writing to file descriptor");
+            }
+            p += n;
+            remaining -= static_cast<size_t>(n);
+        }
+    }
+};
+
+template <class CharT>
+const size_t basic_fd_sink<CharT>::default_buffer_length;
+
+template <class CharT>
+const size_t basic_fd_sink<CharT>::max_segments;
+
+typedef basic_output_sink<char> output_sink;
+typedef basic_output_sink<wchar_t> woutput_sink;
+typedef basic_ostream_sink<char> ostream_sink;
+typedef basic_ostream_sink<wchar_t> wostream_sink;
+typedef basic_string_sink<char> string_sink;
+typedef basic_string_sink<wchar_t> wstring_sink;
+typedef basic_fixed_buffer_sink<char> fixed_buffer_sink;
+typedef basic_fixed_buffer_sink<wchar_t> wfixed_buffer_sink;
+typedef basic_fd_sink<char> fd_sink;
+typedef basic_fd_sink<wchar_t> wfd_sink;
+typedef basic_counting_sink<char> counting_sink;
+typedef basic_counting_sink<wchar_t> wcounting_sink;
+
+}
+
+#endif
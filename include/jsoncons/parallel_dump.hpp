@@ -0,0 +1,339 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_PARALLEL_DUMP_HPP
+#define JSONCONS_PARALLEL_DUMP_HPP
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <iterator>
+#include <algorithm>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/output_sink.hpp>
+
+namespace jsoncons {
+
+namespace detail {
+
+// Serializes a value as basic_json_serializer would, except that an array
+// or object with at least chunks_per_thread*num_threads members or elements
+// is cut into that many chunks, which are serialized on num_threads worker
+// threads into strings and written in order. Smaller arrays and objects are
+// walked into, so that large ones below them are found. At most
+// 2*num_threads chunks are held waiting to be written.
+
+template <class Json>
+class parallel_serializer
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef basic_json_serializer<char_type> serializer_type;
+    typedef std::basic_string<char_type> string_type;
+    typedef typename serializer_type::string_view_type string_view_type;
+
+    static const size_t chunks_per_thread = 4;
+
+    parallel_serializer(serializer_type& serializer, size_t num_threads)
+        : serializer_(serializer), num_threads_(num_threads)
+    {
+    }
+
+    void dump(const Json& val)
+    {
+        serializer_.begin_json();
+        dump_fragment(val);
+        serializer_.end_json();
+    }
+private:
+    typedef typename serializer_type::stack_item stack_item;
+
+    struct chunk
+    {
+        size_t first;
+        size_t last;
+        string_type output;
+        bool unindent_at_end;
+        bool ready;
+        std::exception_ptr error;
+    };
+
+    serializer_type& serializer_;
+    size_t num_threads_;
+
+    size_t min_split_size() const
+    {
+        return chunks_per_thread*num_threads_;
+    }
+
+    void dump_fragment(const Json& val)
+    {
+        if (val.is_array())
+        {
+            serializer_.begin_array();
+            const auto& a = val.array_value();
+            if (num_threads_ > 1 && a.size() >= min_split_size())
+            {
+                dump_chunks(val, a.size());
+            }
+            else if (a.is_packed())
+            {
+                a.packed().dump(serializer_);
+            }
+            else
+            {
+                for (const auto& element : val.array_range())
+                {
+                    dump_fragment(element);
+                }
+            }
+            serializer_.end_array();
+        }
+        else if (val.is_object())
+        {
+            serializer_.begin_object();
+            if (num_threads_ > 1 && val.size() >= min_split_size())
+            {
+                dump_chunks(val, val.size());
+            }
+            else
+            {
+                for (const auto& member : val.object_range())
+                {
+                    serializer_.name(string_view_type(member.key().data(),member.key().length()));
+                    dump_fragment(member.value());
+                }
+            }
+            serializer_.end_object();
+        }
+        else
+        {
+            val.dump_fragment(serializer_);
+        }
+    }
+
+    // Serializes members or elements [first,last) of val as a part of the
+    // innermost open object or array of a serializer in the given state
+    static void dump_chunk(const Json& val, chunk& c,
+                           const basic_serialization_options<char_type>& options,
+                           bool indenting, int indent, const stack_item& outer)
+    {
+        basic_string_sink<char_type> sink(c.output);
+        serializer_type part(sink, options, indenting, indent, outer, c.first);
+        if (val.is_array())
+        {
+            const auto& a = val.array_value();
+            if (a.is_packed())
+            {
+                a.packed().dump(part, c.first, c.last);
+            }
+            else
+            {
+                auto it = std::next(val.array_range().begin(), c.first);
+                for (size_t i = c.first; i < c.last; ++i, ++it)
+                {
+                    it->dump_fragment(part);
+                }
+            }
+        }
+        else
+        {
+            auto it = std::next(val.object_range().begin(), c.first);
+            for (size_t i = c.first; i < c.last; ++i, ++it)
+            {
+                part.name(string_view_type(it->key().data(),it->key().length()));
+                it->value().dump_fragment(part);
+            }
+        }
+        part.bos_.flush();
+        c.unindent_at_end = part.part_unindents_at_end();
+    }
+
+    void dump_chunks(const Json& val, size_t size)
+    {
+        const size_t num_chunks = min_split_size();
+        std::vector<chunk> chunks(num_chunks);
+        for (size_t i = 0; i < num_chunks; ++i)
+        {
+            chunks[i].first = size*i/num_chunks;
+            chunks[i].last = size*(i + 1)/num_chunks;
+            chunks[i].unindent_at_end = false;
+            chunks[i].ready = false;
+        }
+
+        // The state that the workers start from, taken before any of the
+        // output of this object or array is written
+        const basic_serialization_options<char_type>& options = serializer_.options_;
+        const bool indenting = serializer_.indenting_;
+        const int indent = serializer_.indent_;
+        const stack_item outer = serializer_.stack_.back();
+
+        std::mutex mutex;
+        std::condition_variable ready_cv;
+        std::condition_variable window_cv;
+        size_t next = 0;
+        size_t written = 0;
+        bool stop = false;
+        const size_t window = 2*num_threads_;
+
+        auto work = [&]()
+        {
+            for (;;)
+            {
+                size_t index;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    window_cv.wait(lock, [&](){return stop || next == num_chunks || next < written + window;});
+                    if (stop || next == num_chunks)
+                    {
+                        return;
+                    }
+                    index = next++;
+                }
+                chunk& c = chunks[index];
+                try
+                {
+                    dump_chunk(val, c, options, indenting, indent, outer);
+                }
+                catch (...)
+                {
+                    c.error = std::current_exception();
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    c.ready = true;
+                }
+                ready_cv.notify_all();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        auto join_workers = [&]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            window_cv.notify_all();
+            for (auto& worker : workers)
+            {
+                worker.join();
+            }
+            workers.clear();
+        };
+
+        try
+        {
+            for (size_t i = 0; i < num_threads_; ++i)
+            {
+                workers.emplace_back(work);
+            }
+            for (size_t i = 0; i < num_chunks; ++i)
+            {
+                chunk& c = chunks[i];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready_cv.wait(lock, [&](){return c.ready;});
+                }
+                if (c.error)
+                {
+                    std::rethrow_exception(c.error);
+                }
+                serializer_.write_part(c.output.data(), c.output.length(), c.last - c.first, c.unindent_at_end);
+                string_type().swap(c.output);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    ++written;
+                }
+                window_cv.notify_all();
+            }
+        }
+        catch (...)
+        {
+            join_workers();
+            throw;
+        }
+        join_workers();
+    }
+};
+
+template <class Json>
+const size_t parallel_serializer<Json>::chunks_per_thread;
+
+inline size_t default_parallel_dump_threads()
+{
+    const unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+}
+
+// parallel_dump
+
+// Writes val as dump does, serializing large arrays and objects on
+// num_threads threads (by default, one per hardware thread). The output is
+// the same as that of dump.
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   basic_output_sink<typename Json::char_type>& sink,
+                   const basic_serialization_options<typename Json::char_type>& options,
+                   bool pprint,
+                   size_t num_threads = 0)
+{
+    basic_json_serializer<typename Json::char_type> serializer(sink, options, pprint);
+    detail::parallel_serializer<Json> parallel(serializer, num_threads > 0 ? num_threads : detail::default_parallel_dump_threads());
+    parallel.dump(val);
+}
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   basic_output_sink<typename Json::char_type>& sink,
+                   const basic_serialization_options<typename Json::char_type>& options)
+{
+    parallel_dump(val, sink, options, false);
+}
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   basic_output_sink<typename Json::char_type>& sink)
+{
+    parallel_dump(val, sink, basic_serialization_options<typename Json::char_type>(), false);
+}
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   std::basic_ostream<typename Json::char_type>& os,
+                   const basic_serialization_options<typename Json::char_type>& options,
+                   bool pprint,
+                   size_t num_threads = 0)
+{
+    basic_ostream_sink<typename Json::char_type> sink(os);
+    parallel_dump(val, sink, options, pprint, num_threads);
+}
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   std::basic_ostream<typename Json::char_type>& os,
+                   const basic_serialization_options<typename Json::char_type>& options)
+{
+    parallel_dump(val, os, options, false);
+}
+
+template <class Json>
+void parallel_dump(const Json& val,
+                   std::basic_ostream<typename Json::char_type>& os)
+{
+    parallel_dump(val, os, basic_serialization_options<typename Json::char_type>(), false);
+}
+
+}
+
+#endif
@@ -17,6 +17,7 @@
 #include <cwchar>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/jsoncons_utilities.hpp>
+#include <jsoncons/detail/escape_scan.hpp>
 
 namespace jsoncons {
 
@@ -42,6 +43,7 @@ class basic_serialization_options
     std::basic_string<CharT> neg_inf_replacement_;
     bool escape_all_non_ascii_;
     bool escape_solidus_;
+    bool cache_escaped_keys_;
 
     line_split_kind object_object_split_lines_;
     line_split_kind object_array_split_lines_;
@@ -64,6 +66,7 @@ public:
         neg_inf_replacement_(detail::null_literal<CharT>()),
         escape_all_non_ascii_(false),
         escape_solidus_(false),
+        cache_escaped_keys_(false),
         object_object_split_lines_(line_split_kind::multi_line),
         object_array_split_lines_(line_split_kind::same_line),
         array_array_split_lines_(line_split_kind::new_line),
@@ -148,6 +151,11 @@ public:
         return escape_solidus_;
     }
 
+    bool cache_escaped_keys() const
+    {
+        return cache_escaped_keys_;
+    }
+
     bool replace_nan() const {return replace_nan_;}
 
     bool replace_pos_inf() const {return replace_pos_inf_;}
@@ -189,6 +197,14 @@ public:
         return *this;
     }
 
+    // Keep the escaped and quoted forms of recently written member names,
+    // and copy them when the same names are written again
+    basic_serialization_options<CharT>& cache_escaped_keys(bool value)
+    {
+        cache_escaped_keys_ = value;
+        return *this;
+    }
+
     basic_serialization_options<CharT>& replace_nan(bool replace)
     {
         replace_nan_ = replace;
@@ -249,6 +265,18 @@ void escape_string(const CharT* s,
     const CharT* end = s + length;
     for (const CharT* it = begin; it != end; ++it)
     {
+        // Copy the run of characters that need no escaping in one write, or
+        // pass it to a sink that takes long runs by reference
+        const CharT* run_end = detail::find_escape_candidate(it, end, options.escape_solidus(), options.escape_all_non_ascii());
+        if (run_end != it)
+        {
+            os.write_stable(it, run_end - it);
+            it = run_end;
+            if (it == end)
+            {
+                break;
+            }
+        }
         CharT c = *it;
         switch (c)
         {
@@ -0,0 +1,154 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_SHARED_JSON_HPP
+#define JSONCONS_SHARED_JSON_HPP
+
+#include <memory>
+#include <atomic>
+#include <utility>
+#include <jsoncons/json.hpp>
+
+namespace jsoncons {
+
+// basic_shared_json
+
+// An immutable, reference counted handle to a json document. The document
+// is kept as given, packed arrays stay packed and copy-on-write subtrees
+// stay shared. Const access to a json value does not modify it, except 
+// through state it publishes atomically, so concurrent reads through any 
+// number of handles are safe. Snapshots are swapped with atomic_load, 
+// atomic_store and atomic_exchange.
+
+template <class Json>
+class basic_shared_json
+{
+public:
+    typedef Json value_type;
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_view_type string_view_type;
+
+    basic_shared_json() JSONCONS_NOEXCEPT
+    {
+    }
+
+    explicit basic_shared_json(Json&& val)
+        : ptr_(make_document(std::move(val)))
+    {
+    }
+
+    explicit basic_shared_json(const Json& val)
+        : ptr_(make_document(Json(val)))
+    {
+    }
+
+    basic_shared_json(const basic_shared_json&) = default;
+
+    basic_shared_json(basic_shared_json&& val) JSONCONS_NOEXCEPT
+        : ptr_(std::move(val.ptr_))
+    {
+    }
+
+    basic_shared_json& operator=(const basic_shared_json&) = default;
+
+    basic_shared_json& operator=(basic_shared_json&& val) JSONCONS_NOEXCEPT
+    {
+        ptr_ = std::move(val.ptr_);
+        return *this;
+    }
+
+    static basic_shared_json parse(const string_view_type& s)
+    {
+        return basic_shared_json(Json::parse(s));
+    }
+
+    const Json& get() const
+    {
+        JSONCONS_ASSERT(ptr_ != nullptr);
+        return *ptr_;
+    }
+
+    const Json& operator*() const
+    {
+        return get();
+    }
+
+    const Json* operator->() const
+    {
+        return &get();
+    }
+
+    explicit operator bool() const JSONCONS_NOEXCEPT
+    {
+        return ptr_ != nullptr;
+    }
+
+    long use_count() const JSONCONS_NOEXCEPT
+    {
+        return ptr_.use_count();
+    }
+
+    void reset() JSONCONS_NOEXCEPT
+    {
+        ptr_.reset();
+    }
+
+    void swap(basic_shared_json& val) JSONCONS_NOEXCEPT
+    {
+        ptr_.swap(val.ptr_);
+    }
+
+    friend bool operator==(const basic_shared_json& lhs, const basic_shared_json& rhs)
+    {
+        return lhs.ptr_ == rhs.ptr_ || (lhs.ptr_ != nullptr && rhs.ptr_ != nullptr && *lhs.ptr_ == *rhs.ptr_);
+    }
+
+    friend bool operator!=(const basic_shared_json& lhs, const basic_shared_json& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend void swap(basic_shared_json& lhs, basic_shared_json& rhs) JSONCONS_NOEXCEPT
+    {
+        lhs.swap(rhs);
+    }
+
+    friend basic_shared_json atomic_load(const basic_shared_json* p, std::memory_order order = std::memory_order_seq_cst)
+    {
+        return basic_shared_json(std::atomic_load_explicit(&(p->ptr_), order));
+    }
+
+    friend void atomic_store(basic_shared_json* p, basic_shared_json val, std::memory_order order = std::memory_order_seq_cst)
+    {
+        std::atomic_store_explicit(&(p->ptr_), std::move(val.ptr_), order);
+    }
+
+    friend basic_shared_json atomic_exchange(basic_shared_json* p, basic_shared_json val, std::memory_order order = std::memory_order_seq_cst)
+    {
+        return basic_shared_json(std::atomic_exchange_explicit(&(p->ptr_), std::move(val.ptr_), order));
+    }
+private:
+    std::shared_ptr<const Json> ptr_;
+
+    explicit basic_shared_json(std::shared_ptr<const Json>&& ptr) JSONCONS_NOEXCEPT
+        : ptr_(std::move(ptr))
+    {
+    }
+
+    static std::shared_ptr<const Json> make_document(Json&& val)
+    {
+        return std::make_shared<Json>(std::move(val));
+    }
+};
+
+typedef basic_shared_json<json> shared_json;
+typedef basic_shared_json<wjson> wshared_json;
+typedef basic_shared_json<ojson> shared_ojson;
+typedef basic_shared_json<wojson> wshared_ojson;
+
+}
+
+#endif
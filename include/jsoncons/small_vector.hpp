@@ -0,0 +1,593 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_SMALL_VECTOR_HPP
+#define JSONCONS_SMALL_VECTOR_HPP
+
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include <jsoncons/detail/type_traits_helper.hpp>
+
+namespace jsoncons {
+
+// small_vector
+
+// A sequence container with the interface of std::vector that keeps up to
+// N elements in storage embedded in the container itself, and only
+// allocates from the heap when it grows past N. Iterators are plain
+// pointers and are invalidated by any operation that changes the size.
+
+template <class T, size_t N, class Allocator = std::allocator<T>>
+class small_vector
+{
+public:
+    typedef T value_type;
+    typedef Allocator allocator_type;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    static const size_t inline_capacity = N;
+private:
+    typedef typename std::allocator_traits<Allocator>:: template rebind_alloc<T> element_allocator_type;
+    typedef std::allocator_traits<element_allocator_type> element_traits;
+    typedef typename element_traits::pointer element_pointer;
+
+    element_allocator_type allocator_;
+    T* data_;
+    size_t size_;
+    size_t capacity_;
+    typename std::aligned_storage<sizeof(T)*(N > 0 ? N : 1),std::alignment_of<T>::value>::type storage_;
+public:
+    small_vector()
+        : allocator_(), data_(inline_data()), size_(0), capacity_(N)
+    {
+    }
+
+    explicit small_vector(const allocator_type& allocator)
+        : allocator_(allocator), data_(inline_data()), size_(0), capacity_(N)
+    {
+    }
+
+    explicit small_vector(size_t n, const allocator_type& allocator = allocator_type())
+        : allocator_(allocator), data_(inline_data()), size_(0), capacity_(N)
+    {
+        resize(n);
+    }
+
+    small_vector(size_t n, const T& value, const allocator_type& allocator = allocator_type())
+        : allocator_(allocator), data_(inline_data()), size_(0), capacity_(N)
+    {
+        resize(n, value);
+    }
+
+    template <class InputIt>
+    small_vector(InputIt first, InputIt last, const allocator_type& allocator = allocator_type(),
+                 typename std::enable_if<!std::is_integral<InputIt>::value>::type* = 0)
+        : allocator_(allocator), data_(inline_data()), size_(0), capacity_(N)
+    {
+        assign(first, last);
+    }
+
+    small_vector(std::initializer_list<T> init, const allocator_type& allocator = allocator_type())
+        : allocator_(allocator), data_(inline_data()), size_(0), capacity_(N)
+    {
+        assign(init.begin(), init.end());
+    }
+
+    small_vector(const small_vector& val)
+        : allocator_(element_traits::select_on_container_copy_construction(val.allocator_)),
+          data_(inline_data()), size_(0), capacity_(N)
+    {
+        assign(val.begin(), val.end());
+    }
+
+    small_vector(const small_vector& val, const allocator_type& allocator)
+        : allocator_(allocator), data_(inline_data()), size_(0), capacity_(N)
+    {
+        assign(val.begin(), val.end());
+    }
+
+    small_vector(small_vector&& val) JSONCONS_NOEXCEPT
+        : allocator_(val.allocator_), data_(inline_data()), size_(0), capacity_(N)
+    {
+        take(val);
+    }
+
+    small_vector(small_vector&& val, const allocator_type& allocator)
+        : allocator_(allocator), data_(inline_data()), size_(0), capacity_(N)
+    {
+        if (allocator_ == val.allocator_)
+        {
+            take(val);
+        }
+        else
+        {
+            move_elements(val);
+        }
+    }
+
+    ~small_vector()
+    {
+        clear();
+        release();
+    }
+
+    small_vector& operator=(const small_vector& val)
+    {
+        if (this != &val)
+        {
+            assign(val.begin(), val.end());
+        }
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& val)
+    {
+        if (this != &val)
+        {
+            clear();
+            if (allocator_ == val.allocator_)
+            {
+                release();
+                take(val);
+            }
+            else
+            {
+                move_elements(val);
+            }
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<T> init)
+    {
+        assign(init.begin(), init.end());
+        return *this;
+    }
+
+    template <class InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        append(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    allocator_type get_allocator() const
+    {
+        return allocator_;
+    }
+
+    // Element access
+
+    reference operator[](size_t i) {return data_[i];}
+    const_reference operator[](size_t i) const {return data_[i];}
+
+    reference at(size_t i)
+    {
+        if (i >= size_)
+        {
+            throw std::out_of_range("Invalid small_vector index");
+        }
+        return data_[i];
+    }
+
+    const_reference at(size_t i) const
+    {
+        if (i >= size_)
+        {
+            throw std::out_of_range("Invalid small_vector index");
+        }
+        return data_[i];
+    }
+
+    reference front() {return data_[0];}
+    const_reference front() const {return data_[0];}
+    reference back() {return data_[size_-1];}
+    const_reference back() const {return data_[size_-1];}
+
+    T* data() JSONCONS_NOEXCEPT {return data_;}
+    const T* data() const JSONCONS_NOEXCEPT {return data_;}
+
+    // Iterators
+
+    iterator begin() JSONCONS_NOEXCEPT {return data_;}
+    iterator end() JSONCONS_NOEXCEPT {return data_ + size_;}
+    const_iterator begin() const JSONCONS_NOEXCEPT {return data_;}
+    const_iterator end() const JSONCONS_NOEXCEPT {return data_ + size_;}
+    const_iterator cbegin() const JSONCONS_NOEXCEPT {return data_;}
+    const_iterator cend() const JSONCONS_NOEXCEPT {return data_ + size_;}
+    reverse_iterator rbegin() JSONCONS_NOEXCEPT {return reverse_iterator(end());}
+    reverse_iterator rend() JSONCONS_NOEXCEPT {return reverse_iterator(begin());}
+    const_reverse_iterator rbegin() const JSONCONS_NOEXCEPT {return const_reverse_iterator(end());}
+    const_reverse_iterator rend() const JSONCONS_NOEXCEPT {return const_reverse_iterator(begin());}
+
+    // Capacity
+
+    bool empty() const JSONCONS_NOEXCEPT {return size_ == 0;}
+    size_t size() const JSONCONS_NOEXCEPT {return size_;}
+    size_t capacity() const JSONCONS_NOEXCEPT {return capacity_;}
+    size_t max_size() const JSONCONS_NOEXCEPT {return element_traits::max_size(allocator_);}
+
+    // Returns true while the elements are held in the embedded storage
+    bool is_inline() const JSONCONS_NOEXCEPT {return data_ == inline_data();}
+
+    void reserve(size_t n)
+    {
+        if (n > capacity_)
+        {
+            reallocate(n);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        if (!is_inline() && size_ < capacity_)
+        {
+            reallocate(size_);
+        }
+    }
+
+    // Modifiers
+
+    void clear() JSONCONS_NOEXCEPT
+    {
+        destroy(data_, data_ + size_);
+        size_ = 0;
+    }
+
+    void push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <class... Args>
+    reference emplace_back(Args&&... args)
+    {
+        if (size_ == capacity_)
+        {
+            // Construct first, args may refer to an element of this container
+            T value(std::forward<Args>(args)...);
+            reallocate(next_capacity(size_+1));
+            element_traits::construct(allocator_, data_ + size_, std::move(value));
+        }
+        else
+        {
+            element_traits::construct(allocator_, data_ + size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return back();
+    }
+
+    void pop_back()
+    {
+        --size_;
+        element_traits::destroy(allocator_, data_ + size_);
+    }
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args)
+    {
+        size_t index = pos - data_;
+        if (index == size_)
+        {
+            emplace_back(std::forward<Args>(args)...);
+        }
+        else
+        {
+            T value(std::forward<Args>(args)...);
+            if (size_ == capacity_)
+            {
+                reallocate(next_capacity(size_+1));
+            }
+            element_traits::construct(allocator_, data_ + size_, std::move(data_[size_-1]));
+            ++size_;
+            std::move_backward(data_ + index, data_ + size_ - 2, data_ + size_ - 1);
+            data_[index] = std::move(value);
+        }
+        return data_ + index;
+    }
+
+    iterator insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    iterator insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    template <class InputIt>
+    typename std::enable_if<!std::is_integral<InputIt>::value,iterator>::type
+    insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        size_t index = pos - data_;
+        size_t old_size = size_;
+        append(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+        std::rotate(data_ + index, data_ + old_size, data_ + size_);
+        return data_ + index;
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos+1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T* p = data_ + (first - data_);
+        if (first != last)
+        {
+            T* new_end = std::move(data_ + (last - data_), data_ + size_, p);
+            destroy(new_end, data_ + size_);
+            size_ = new_end - data_;
+        }
+        return p;
+    }
+
+    void resize(size_t n)
+    {
+        if (n < size_)
+        {
+            erase(data_ + n, data_ + size_);
+        }
+        else
+        {
+            reserve(n);
+            while (size_ < n)
+            {
+                element_traits::construct(allocator_, data_ + size_);
+                ++size_;
+            }
+        }
+    }
+
+    void resize(size_t n, const T& value)
+    {
+        if (n < size_)
+        {
+            erase(data_ + n, data_ + size_);
+        }
+        else
+        {
+            if (n > capacity_)
+            {
+                T copy(value);
+                reallocate(n);
+                fill(n, copy);
+            }
+            else
+            {
+                fill(n, value);
+            }
+        }
+    }
+
+    void swap(small_vector& val)
+    {
+        if (!is_inline() && !val.is_inline())
+        {
+            std::swap(allocator_, val.allocator_);
+            std::swap(data_, val.data_);
+            std::swap(size_, val.size_);
+            std::swap(capacity_, val.capacity_);
+        }
+        else
+        {
+            small_vector temp(std::move(val));
+            val = std::move(*this);
+            *this = std::move(temp);
+        }
+    }
+
+    friend void swap(small_vector& lhs, small_vector& rhs)
+    {
+        lhs.swap(rhs);
+    }
+
+    friend bool operator==(const small_vector& lhs, const small_vector& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+    friend bool operator!=(const small_vector& lhs, const small_vector& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+    friend bool operator<(const small_vector& lhs, const small_vector& rhs)
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+private:
+    T* inline_data() JSONCONS_NOEXCEPT
+    {
+        return reinterpret_cast<T*>(&storage_);
+    }
+
+    const T* inline_data() const JSONCONS_NOEXCEPT
+    {
+        return reinterpret_cast<const T*>(&storage_);
+    }
+
+    size_t next_capacity(size_t n) const
+    {
+        return (std::max)(n, 2*capacity_);
+    }
+
+    void destroy(T* first, T* last) JSONCONS_NOEXCEPT
+    {
+        for (; first != last; ++first)
+        {
+            element_traits::destroy(allocator_, first);
+        }
+    }
+
+    // Frees heap storage, if any, and returns to the embedded storage
+    void release() JSONCONS_NOEXCEPT
+    {
+        if (!is_inline())
+        {
+            element_traits::deallocate(allocator_, std::pointer_traits<element_pointer>::pointer_to(*data_), capacity_);
+            data_ = inline_data();
+            capacity_ = N;
+        }
+    }
+
+    // Moves the elements to storage of capacity n >= size_, the embedded
+    // storage if n <= N
+    void reallocate(size_t n)
+    {
+        T* p;
+        element_pointer heap = element_pointer();
+        if (n <= N)
+        {
+            if (is_inline())
+            {
+                return;
+            }
+            p = inline_data();
+            n = N;
+        }
+        else
+        {
+            heap = element_traits::allocate(allocator_, n);
+            p = to_plain_pointer(heap);
+        }
+        size_t count = 0;
+        try
+        {
+            for (; count < size_; ++count)
+            {
+                element_traits::construct(allocator_, p + count, std::move_if_noexcept(data_[count]));
+            }
+        }
+        catch (...)
+        {
+            destroy(p, p + count);
+            if (p != inline_data())
+            {
+                element_traits::deallocate(allocator_, heap, n);
+            }
+            throw;
+        }
+        destroy(data_, data_ + size_);
+        release();
+        data_ = p;
+        capacity_ = n;
+    }
+
+    // Takes the contents of val, which has an equal allocator
+    void take(small_vector& val) JSONCONS_NOEXCEPT
+    {
+        if (val.is_inline())
+        {
+            move_elements(val);
+        }
+        else
+        {
+            data_ = val.data_;
+            size_ = val.size_;
+            capacity_ = val.capacity_;
+            val.data_ = val.inline_data();
+            val.size_ = 0;
+            val.capacity_ = N;
+        }
+    }
+
+    void move_elements(small_vector& val)
+    {
+        reserve(val.size_);
+        for (size_t i = 0; i < val.size_; ++i)
+        {
+            element_traits::construct(allocator_, data_ + size_, std::move(val.data_[i]));
+            ++size_;
+        }
+        val.clear();
+    }
+
+    void fill(size_t n, const T& value)
+    {
+        while (size_ < n)
+        {
+            element_traits::construct(allocator_, data_ + size_, value);
+            ++size_;
+        }
+    }
+
+    template <class InputIt>
+    void append(InputIt first, InputIt last, std::input_iterator_tag)
+    {
+        for (; first != last; ++first)
+        {
+            emplace_back(*first);
+        }
+    }
+
+    template <class ForwardIt>
+    void append(ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+        reserve(size_ + std::distance(first, last));
+        for (; first != last; ++first)
+        {
+            element_traits::construct(allocator_, data_ + size_, *first);
+            ++size_;
+        }
+    }
+};
+
+template <class T, size_t N, class Allocator>
+const size_t small_vector<T,N,Allocator>::inline_capacity;
+
+namespace detail {
+
+// container_iterators
+
+// The iterator types of a container, named without instantiating the
+// container, since a small_vector of an incomplete type cannot be instantiated
+
+template <class Container>
+struct container_iterators
+{
+    typedef typename Container::iterator iterator;
+    typedef typename Container::const_iterator const_iterator;
+};
+
+template <class T, size_t N, class Allocator>
+struct container_iterators<small_vector<T,N,Allocator>>
+{
+    typedef T* iterator;
+    typedef const T* const_iterator;
+};
+
+}
+
+}
+
+#endif
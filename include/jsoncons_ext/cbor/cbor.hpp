@@ -905,6 +905,116 @@ struct cbor_Encoder_
         return n;
     }
 
+    template <class Action, class Result>
+    static void encode_integer(int64_t val, Action action, Result& v)
+    {
+        if (val >= 0)
+        {
+            if (val <= 0x17)
+            {
+                action(static_cast<uint8_t>(val), v);
+            } else if (val <= (std::numeric_limits<uint8_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x18), v);
+                action(static_cast<uint8_t>(val), v);
+            } else if (val <= (std::numeric_limits<uint16_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x19), v);
+                action(static_cast<uint16_t>(val), v);
+            } else if (val <= (std::numeric_limits<uint32_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x1a), v);
+                action(static_cast<uint32_t>(val), v);
+            } else if (val <= (std::numeric_limits<int64_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x1b), v);
+                action(static_cast<int64_t>(val), v);
+            }
+        } else
+        {
+            const auto posnum = -1 - val;
+            if (val >= -24)
+            {
+                action(static_cast<uint8_t>(0x20 + posnum), v);
+            } else if (posnum <= (std::numeric_limits<uint8_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x38), v);
+                action(static_cast<uint8_t>(posnum), v);
+            } else if (posnum <= (std::numeric_limits<uint16_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x39), v);
+                action(static_cast<uint16_t>(posnum), v);
+            } else if (posnum <= (std::numeric_limits<uint32_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x3a), v);
+                action(static_cast<uint32_t>(posnum), v);
+            } else if (posnum <= (std::numeric_limits<int64_t>::max)())
+            {
+                action(static_cast<uint8_t>(0x3b), v);
+                action(static_cast<int64_t>(posnum), v);
+            }
+        }
+    }
+
+    template <class Action, class Result>
+    static void encode_uinteger(uint64_t val, Action action, Result& v)
+    {
+        if (val <= 0x17)
+        {
+            action(static_cast<uint8_t>(val),v);
+        } else if (val <=(std::numeric_limits<uint8_t>::max)())
+        {
+            action(static_cast<uint8_t>(0x18), v);
+            action(static_cast<uint8_t>(val),v);
+        } else if (val <=(std::numeric_limits<uint16_t>::max)())
+        {
+            action(static_cast<uint8_t>(0x19), v);
+            action(static_cast<uint16_t>(val),v);
+        } else if (val <=(std::numeric_limits<uint32_t>::max)())
+        {
+            action(static_cast<uint8_t>(0x1a), v);
+            action(static_cast<uint32_t>(val),v);
+        } else if (val <=(std::numeric_limits<uint64_t>::max)())
+        {
+            action(static_cast<uint8_t>(0x1b), v);
+            action(static_cast<uint64_t>(val),v);
+        }
+    }
+
+    template <class Action, class Result>
+    static void encode_double(double val, Action action, Result& v)
+    {
+        action(static_cast<uint8_t>(0xfb), v);
+        action(val,v);
+    }
+
+    template <class PackedArray, class Action, class Result>
+    static void encode_packed(const PackedArray& packed, Action action, Result& v)
+    {
+        const size_t length = packed.size();
+        switch (packed.type_id())
+        {
+        case json_type_tag::integer_t:
+            for (size_t i = 0; i < length; ++i)
+            {
+                encode_integer(packed.integer_at(i), action, v);
+            }
+            break;
+        case json_type_tag::uinteger_t:
+            for (size_t i = 0; i < length; ++i)
+            {
+                encode_uinteger(packed.uinteger_at(i), action, v);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < length; ++i)
+            {
+                encode_double(packed.double_at(i), action, v);
+            }
+            break;
+        }
+    }
+
     template <class Action, class Result>
     static void encode(const Json& jval, Action action, Result& v)
     {
@@ -924,86 +1034,19 @@ struct cbor_Encoder_
 
         case json_type_tag::integer_t:
             {
-                int64_t val = jval.as_integer();
-                if (val >= 0)
-                {
-                    if (val <= 0x17)
-                    {
-                        action(static_cast<uint8_t>(val), v);
-                    } else if (val <= (std::numeric_limits<uint8_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x18), v);
-                        action(static_cast<uint8_t>(val), v);
-                    } else if (val <= (std::numeric_limits<uint16_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x19), v);
-                        action(static_cast<uint16_t>(val), v);
-                    } else if (val <= (std::numeric_limits<uint32_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x1a), v);
-                        action(static_cast<uint32_t>(val), v);
-                    } else if (val <= (std::numeric_limits<int64_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x1b), v);
-                        action(static_cast<int64_t>(val), v);
-                    }
-                } else
-                {
-                    const auto posnum = -1 - val;
-                    if (val >= -24)
-                    {
-                        action(static_cast<uint8_t>(0x20 + posnum), v);
-                    } else if (posnum <= (std::numeric_limits<uint8_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x38), v);
-                        action(static_cast<uint8_t>(posnum), v);
-                    } else if (posnum <= (std::numeric_limits<uint16_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x39), v);
-                        action(static_cast<uint16_t>(posnum), v);
-                    } else if (posnum <= (std::numeric_limits<uint32_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x3a), v);
-                        action(static_cast<uint32_t>(posnum), v);
-                    } else if (posnum <= (std::numeric_limits<int64_t>::max)())
-                    {
-                        action(static_cast<uint8_t>(0x3b), v);
-                        action(static_cast<int64_t>(posnum), v);
-                    }
-                }
+                encode_integer(jval.as_integer(), action, v);
                 break;
             }
 
         case json_type_tag::uinteger_t:
             {
-                uint64_t val = jval.as_uinteger();
-                if (val <= 0x17)
-                {
-                    action(static_cast<uint8_t>(val),v);
-                } else if (val <=(std::numeric_limits<uint8_t>::max)())
-                {
-                    action(static_cast<uint8_t>(0x18), v);
-                    action(static_cast<uint8_t>(val),v);
-                } else if (val <=(std::numeric_limits<uint16_t>::max)())
-                {
-                    action(static_cast<uint8_t>(0x19), v);
-                    action(static_cast<uint16_t>(val),v);
-                } else if (val <=(std::numeric_limits<uint32_t>::max)())
-                {
-                    action(static_cast<uint8_t>(0x1a), v);
-                    action(static_cast<uint32_t>(val),v);
-                } else if (val <=(std::numeric_limits<uint64_t>::max)())
-                {
-                    action(static_cast<uint8_t>(0x1b), v);
-                    action(static_cast<uint64_t>(val),v);
-                }
+                encode_uinteger(jval.as_uinteger(), action, v);
                 break;
             }
 
         case json_type_tag::double_t:
             {
-                action(static_cast<uint8_t>(0xfb), v);
-                action(jval.as_double(),v);
+                encode_double(jval.as_double(), action, v);
                 break;
             }
 
@@ -1045,9 +1088,16 @@ struct cbor_Encoder_
                 }
 
                 // append each element
-                for (const auto& el : jval.array_range())
+                if (jval.array_value().is_packed())
                 {
-                    encode(el,action,v);
+                    encode_packed(jval.array_value().packed(), action, v);
+                }
+                else
+                {
+                    for (const auto& el : jval.array_range())
+                    {
+                        encode(el,action,v);
+                    }
                 }
                 break;
             }
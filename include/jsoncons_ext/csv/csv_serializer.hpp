@@ -400,9 +400,7 @@ private:
     {
         begin_value(os);
 
-        std::basic_ostringstream<CharT> ss;
-        ss << val;
-        os.write(ss.str());
+        print_integer(val,os);
 
         end_value();
     }
@@ -411,9 +409,7 @@ private:
     {
         begin_value(os);
 
-        std::basic_ostringstream<CharT> ss;
-        ss << val;
-        os.write(ss.str());
+        print_uinteger(val,os);
 
         end_value();
     }
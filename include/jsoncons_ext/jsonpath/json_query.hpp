@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <memory>
 #include <jsoncons/json.hpp>
+#include <jsoncons/json_index.hpp>
 #include "jsonpath_filter.hpp"
 #include "jsonpath_error_category.hpp"
 
@@ -38,6 +39,31 @@ Json json_query(const Json& root, const typename Json::string_view_type& path, r
     }
 }
 
+// Filters of the form [?(@.name == value)] applied to an array use an
+// index over that array and member path, if one is given and current.
+// An index is not current once the array has been accessed non-const 
+// since it was built, and the filter is then evaluated element by element
+template<class Json>
+Json json_query(const Json& root, const typename Json::string_view_type& path, 
+                const std::vector<const basic_json_index<Json>*>& indexes, 
+                result_type result_t = result_type::value)
+{
+    if (result_t == result_type::value)
+    {
+        detail::jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator;
+        evaluator.set_indexes(std::addressof(indexes));
+        evaluator.evaluate(root,path.data(),path.length());
+        return evaluator.get_values();
+    }
+    else
+    {
+        detail::jsonpath_evaluator<Json,const Json&,detail::PathConstructor<Json>> evaluator;
+        evaluator.set_indexes(std::addressof(indexes));
+        evaluator.evaluate(root,path.data(),path.length());
+        return evaluator.get_normalized_paths();
+    }
+}
+
 template<class Json, class T>
 void json_replace(Json& root, const typename Json::string_view_type& path, T&& new_value)
 {
@@ -191,15 +217,25 @@ private:
     {
     private:
          jsonpath_filter_expr<Json> result_;
+         const std::vector<const basic_json_index<Json>*>* indexes_;
     public:
-        filter_selector(const jsonpath_filter_expr<Json>& result)
-            : result_(result)
+        filter_selector(const jsonpath_filter_expr<Json>& result, 
+                        const std::vector<const basic_json_index<Json>*>* indexes)
+            : result_(result), indexes_(indexes)
         {
         }
 
         void select(const string_type& path, reference val, node_set& nodes, std::vector<std::shared_ptr<Json>>&) override
         {
-            if (val.is_array())
+            const basic_json_index<Json>* index = find_index(val);
+            if (index != nullptr)
+            {
+                for (size_t i : index->positions(result_.equality_value()))
+                {
+                    nodes.emplace_back(PathCons()(path,i),std::addressof(val[i]));
+                }
+            }
+            else if (val.is_array())
             {
                 for (size_t i = 0; i < val.size(); ++i)
                 {
@@ -217,6 +253,22 @@ private:
                 }
             }
         }
+    private:
+        const basic_json_index<Json>* find_index(const Json& val) const
+        {
+            if (indexes_ != nullptr && result_.is_member_equality() && val.is_array())
+            {
+                for (const basic_json_index<Json>* index : *indexes_)
+                {
+                    if (std::addressof(index->array()) == std::addressof(val) && index->is_current() 
+                        && index->path() == result_.equality_path())
+                    {
+                        return index;
+                    }
+                }
+            }
+            return nullptr;
+        }
     };
 
     class name_selector : public selector
@@ -391,6 +443,7 @@ private:
     const char_type* end_input_;
     const char_type* p_;
     std::vector<std::shared_ptr<selector>> selectors_;
+    const std::vector<const basic_json_index<Json>*>* indexes_;
 
 public:
     jsonpath_evaluator()
@@ -402,8 +455,13 @@ public:
           recursive_descent_(false),
           line_(0), column_(0),
           begin_input_(nullptr), end_input_(nullptr),
-          p_(nullptr)
+          p_(nullptr), indexes_(nullptr)
+    {
+    }
+
+    void set_indexes(const std::vector<const basic_json_index<Json>*>* indexes)
     {
+        indexes_ = indexes;
     }
 
     Json get_values() const
@@ -638,7 +696,7 @@ public:
                         auto result = parser.parse(root,p_,end_input_,&p_);
                         line_ = parser.line();
                         column_ = parser.column();
-                        selectors_.push_back(std::make_shared<filter_selector>(result));
+                        selectors_.push_back(std::make_shared<filter_selector>(result,indexes_));
                         state_ = path_state::expect_comma_or_right_bracket;
                     }
                     break;                   
@@ -930,9 +988,11 @@ public:
 
             if (p->is_array())
             {
-                for (auto it = p->array_range().begin(); it != p->array_range().end(); ++it)
+                // Access by index, since an iterator over a packed array 
+                // does not return a reference to a stored element
+                for (size_t j = 0; j < p->size(); ++j)
                 {
-                    nodes_.emplace_back(PathCons()(path,it - p->array_range().begin()),std::addressof(*it));
+                    nodes_.emplace_back(PathCons()(path,j),std::addressof((*p)[j]));
                 }
             }
             else if (p->is_object())
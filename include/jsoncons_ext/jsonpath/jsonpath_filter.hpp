@@ -259,6 +259,18 @@ public:
     {
         throw parse_error(jsonpath_parser_errc::invalid_filter_unsupported_operator,1,1);
     }
+
+    // The path of a path operand, otherwise nullptr
+    virtual const string_type* path() const
+    {
+        return nullptr;
+    }
+
+    // The value of a value operand, otherwise nullptr
+    virtual const Json* value() const
+    {
+        return nullptr;
+    }
 };
 
 template <class Json>
@@ -269,6 +281,7 @@ struct operator_properties
     size_t precedence_level;
     bool is_right_associative;
     operator_type op;
+    bool is_equality;
 };
 
 template <class Json>
@@ -289,6 +302,7 @@ class token
     size_t precedence_level_;
     bool is_right_associative_;
     bool is_aggregate_;
+    bool is_equality_;
     std::shared_ptr<term<Json>> operand_ptr_;
     std::function<Json(const term<Json>&)> unary_operator_;
     std::function<Json(const term<Json>&, const term<Json>&)> operator_;
@@ -307,11 +321,11 @@ public:
     }
 
     token(token_type type)
-        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false)
+        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false),is_equality_(false)
     {
     }
     token(token_type type, std::shared_ptr<term<Json>> term_ptr)
-        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false),operand_ptr_(term_ptr)
+        : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false),is_equality_(false),operand_ptr_(term_ptr)
     {
     }
     token(size_t precedence_level, 
@@ -321,6 +335,7 @@ public:
           precedence_level_(precedence_level), 
           is_right_associative_(is_right_associative),
           is_aggregate_(false), 
+          is_equality_(false),
           unary_operator_(unary_operator)
     {
     }
@@ -329,6 +344,7 @@ public:
           precedence_level_(properties.precedence_level), 
           is_right_associative_(properties.is_right_associative),
           is_aggregate_(false), 
+          is_equality_(properties.is_equality),
           operator_(properties.op)
     {
     }
@@ -337,6 +353,7 @@ public:
           precedence_level_(properties.precedence_level), 
           is_right_associative_(properties.is_right_associative), 
           is_aggregate_(properties.is_aggregate),
+          is_equality_(false),
           unary_operator_(properties.op)
     {
     }
@@ -391,7 +408,12 @@ public:
         return is_aggregate_;
     }
 
-    const term<Json>& operand()
+    bool is_equality() const
+    {
+        return is_equality_;
+    }
+
+    const term<Json>& operand() const
     {
         JSONCONS_ASSERT(type_ == token_type::operand && operand_ptr_ != nullptr);
         return *operand_ptr_;
@@ -559,6 +581,11 @@ public:
         return value_;
     }
 
+    const Json* value() const override
+    {
+        return std::addressof(value_);
+    }
+
     Json exclaim() const override
     {
         return !value_.as_bool();
@@ -712,6 +739,11 @@ public:
         nodes_ = evaluator.get_values();
     }
 
+    const string_type* path() const override
+    {
+        return std::addressof(path_);
+    }
+
     bool accept_single_node() const override
     {
         return nodes_.size() != 0;
@@ -1007,15 +1039,58 @@ token<Json> evaluate(const Json& context, std::vector<token<Json>>& tokens)
 template <class Json>
 class jsonpath_filter_expr
 {
+    typedef typename Json::string_type string_type;
+    typedef typename Json::char_type char_type;
 public:
     std::vector<token<Json>> tokens_;
     size_t line_;
     size_t column_;
+    std::vector<string_type> equality_path_;
+    Json equality_value_;
 public:
 
     jsonpath_filter_expr(const std::vector<token<Json>>& tokens, size_t line, size_t column)
         : tokens_(tokens), line_(line), column_(column)
     {
+        // Recognize @.name1.name2 == value and value == @.name1.name2,
+        // which an index over the member path can answer
+        if (tokens_.size() == 3 && tokens_[0].is_operand() && tokens_[1].is_operand() 
+            && tokens_[2].is_binary_operator() && tokens_[2].is_equality())
+        {
+            const term<Json>& a = tokens_[0].operand();
+            const term<Json>& b = tokens_[1].operand();
+            if (a.path() != nullptr && b.value() != nullptr)
+            {
+                if (parse_member_path(*(a.path()),equality_path_))
+                {
+                    equality_value_ = *(b.value());
+                }
+            }
+            else if (a.value() != nullptr && b.path() != nullptr)
+            {
+                if (parse_member_path(*(b.path()),equality_path_))
+                {
+                    equality_value_ = *(a.value());
+                }
+            }
+        }
+    }
+
+    // True if the expression compares the value at a path of member
+    // names with a constant
+    bool is_member_equality() const
+    {
+        return !equality_path_.empty();
+    }
+
+    const std::vector<string_type>& equality_path() const
+    {
+        return equality_path_;
+    }
+
+    const Json& equality_value() const
+    {
+        return equality_value_;
     }
 
     Json eval(const Json& context_node)
@@ -1045,6 +1120,92 @@ public:
             throw parse_error(e.code(),line_,column_);
         }
     }
+private:
+    static bool is_blank(char_type c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // Splits paths of the form @.a.b and @['a']["b"] into member names.
+    // Names that could also select from an array or string (numbers and
+    // length) are refused.
+    static bool parse_member_path(const string_type& path, std::vector<string_type>& names)
+    {
+        std::vector<string_type> result;
+
+        const char_type* p = path.data();
+        const char_type* end = path.data() + path.length();
+        while (p < end && is_blank(*p))
+        {
+            ++p;
+        }
+        while (end > p && is_blank(*(end-1)))
+        {
+            --end;
+        }
+        if (p == end || *p != '@')
+        {
+            return false;
+        }
+        ++p;
+        while (p < end)
+        {
+            string_type name;
+            if (*p == '.')
+            {
+                ++p;
+                while (p < end && *p != '.' && *p != '[')
+                {
+                    switch (*p)
+                    {
+                    case '*':case '(':case ')':case '?':case ':':case ',':case '@':case '$':case '\'':case '"':case ' ':case '\t':
+                        return false;
+                    default:
+                        name.push_back(*p++);
+                        break;
+                    }
+                }
+            }
+            else if (*p == '[' && end - p >= 2 && (*(p+1) == '\'' || *(p+1) == '"'))
+            {
+                char_type quote = *(p+1);
+                p += 2;
+                while (p < end && *p != quote)
+                {
+                    if (*p == '\\')
+                    {
+                        return false;
+                    }
+                    name.push_back(*p++);
+                }
+                if (end - p < 2 || *(p+1) != ']')
+                {
+                    return false;
+                }
+                p += 2;
+            }
+            else
+            {
+                return false;
+            }
+            if (name.empty() || (name[0] >= '0' && name[0] <= '9') || name[0] == '-')
+            {
+                return false;
+            }
+            static const char_type length_name[] = {'l','e','n','g','t','h'};
+            if (name == string_type(length_name,sizeof(length_name)/sizeof(char_type)))
+            {
+                return false;
+            }
+            result.push_back(std::move(name));
+        }
+        if (result.empty())
+        {
+            return false;
+        }
+        names.swap(result);
+        return true;
+    }
 };
 
 template <class Json>
@@ -1125,19 +1286,19 @@ class jsonpath_filter_parser
 
         const binary_operator_map operators =
         {
-            {eqtilde_literal<char_type>(),{2,false,[](const term<Json>& a, const term<Json>& b) {return a.regex_term(b); }}},
-            {star_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.mult_term(b); }}},
-            {forwardslash_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.div_term(b); }}},
-            {plus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.plus_term(b); }}},
-            {minus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.minus_term(b); }}},
-            {lt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b); }}},
-            {lte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b) || a.eq_term(b); }}},
-            {gt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b); }}},
-            {gte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b) || a.eq_term(b); }}},
-            {eq_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.eq_term(b); }}},
-            {ne_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.ne_term(b); }}},
-            {ampamp_literal<char_type>(),{7,false,[](const term<Json>& a, const term<Json>& b) {return a.ampamp_term(b); }}},
-            {pipepipe_literal<char_type>(),{8,false,[](const term<Json>& a, const term<Json>& b) {return a.pipepipe_term(b); }}}
+            {eqtilde_literal<char_type>(),{2,false,[](const term<Json>& a, const term<Json>& b) {return a.regex_term(b); },false}},
+            {star_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.mult_term(b); },false}},
+            {forwardslash_literal<char_type>(),{3,false,[](const term<Json>& a, const term<Json>& b) {return a.div_term(b); },false}},
+            {plus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.plus_term(b); },false}},
+            {minus_literal<char_type>(),{4,false,[](const term<Json>& a, const term<Json>& b) {return a.minus_term(b); },false}},
+            {lt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b); },false}},
+            {lte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b) || a.eq_term(b); },false}},
+            {gt_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b); },false}},
+            {gte_literal<char_type>(),{5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b) || a.eq_term(b); },false}},
+            {eq_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.eq_term(b); },true}},
+            {ne_literal<char_type>(),{6,false,[](const term<Json>& a, const term<Json>& b) {return a.ne_term(b); },false}},
+            {ampamp_literal<char_type>(),{7,false,[](const term<Json>& a, const term<Json>& b) {return a.ampamp_term(b); },false}},
+            {pipepipe_literal<char_type>(),{8,false,[](const term<Json>& a, const term<Json>& b) {return a.pipepipe_term(b); },false}}
         };
 
     public:
@@ -1854,19 +2015,19 @@ public:
 template <class Json>
 const operator_properties<Json> jsonpath_filter_parser<Json>::op_properties_[] =
 {
-    {2,false,[](const term<Json>& a, const term<Json>& b) {return a.regex_term(b);}},
-    {3,false,[](const term<Json>& a, const term<Json>& b) {return a.mult_term(b);}},
-    {3,false,[](const term<Json>& a, const term<Json>& b) {return a.div_term(b);}},
-    {4,false,[](const term<Json>& a, const term<Json>& b) {return a.plus_term(b);}},
-    {4,false,[](const term<Json>& a, const term<Json>& b) {return a.minus_term(b);}},
-    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b);}},
-    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b) || a.eq_term(b);}},
-    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b);}},
-    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b) || a.eq_term(b);}},
-    {6,false,[](const term<Json>& a, const term<Json>& b) {return a.eq_term(b); }},
-    {6,false,[](const term<Json>& a, const term<Json>& b) {return a.ne_term(b); }},
-    {7,false,[](const term<Json>& a, const term<Json>& b) {return a.ampamp_term(b);}},
-    {8,false,[](const term<Json>& a, const term<Json>& b) {return a.pipepipe_term(b);}}
+    {2,false,[](const term<Json>& a, const term<Json>& b) {return a.regex_term(b);},false},
+    {3,false,[](const term<Json>& a, const term<Json>& b) {return a.mult_term(b);},false},
+    {3,false,[](const term<Json>& a, const term<Json>& b) {return a.div_term(b);},false},
+    {4,false,[](const term<Json>& a, const term<Json>& b) {return a.plus_term(b);},false},
+    {4,false,[](const term<Json>& a, const term<Json>& b) {return a.minus_term(b);},false},
+    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b);},false},
+    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.lt_term(b) || a.eq_term(b);},false},
+    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b);},false},
+    {5,false,[](const term<Json>& a, const term<Json>& b) {return a.gt_term(b) || a.eq_term(b);},false},
+    {6,false,[](const term<Json>& a, const term<Json>& b) {return a.eq_term(b); },true},
+    {6,false,[](const term<Json>& a, const term<Json>& b) {return a.ne_term(b); },false},
+    {7,false,[](const term<Json>& a, const term<Json>& b) {return a.ampamp_term(b);},false},
+    {8,false,[](const term<Json>& a, const term<Json>& b) {return a.pipepipe_term(b);},false}
 };
 
 }}}
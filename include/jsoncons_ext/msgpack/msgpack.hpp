@@ -75,6 +75,144 @@ public:
         return n;
     }
 
+    template <class Action, class Result>
+    static void encode_integer(int64_t val, Action action, Result& v)
+    {
+        if (val >= 0)
+        {
+            if (val <= (std::numeric_limits<int8_t>::max)())
+            {
+                // positive fixnum stores 7-bit positive integer
+                action(static_cast<int8_t>(val),v);
+            }
+            else if (val <= (std::numeric_limits<uint8_t>::max)())
+            {
+                // uint 8 stores a 8-bit unsigned integer
+                action(static_cast<uint8_t>(msgpack_format::uint8_cd), v);
+                action(static_cast<uint8_t>(val),v);
+            }
+            else if (val <= (std::numeric_limits<uint16_t>::max)())
+            {
+                // uint 16 stores a 16-bit big-endian unsigned integer
+                action(static_cast<uint8_t>(msgpack_format::uint16_cd), v);
+                action(static_cast<uint16_t>(val),v);
+            }
+            else if (val <= (std::numeric_limits<uint32_t>::max)())
+            {
+                // uint 32 stores a 32-bit big-endian unsigned integer
+                action(static_cast<uint8_t>(msgpack_format::uint32_cd), v);
+                action(static_cast<uint32_t>(val),v);
+            }
+            else if (val <= (std::numeric_limits<int64_t>::max)())
+            {
+                // int 64 stores a 64-bit big-endian signed integer
+                action(static_cast<uint8_t>(msgpack_format::int64_cd), v);
+                action(static_cast<int64_t>(val),v);
+            }
+        }
+        else
+        {
+            if (val >= -32)
+            {
+                // negative fixnum stores 5-bit negative integer
+                action(static_cast<int8_t>(val), v);
+            }
+            else if (val >= (std::numeric_limits<int8_t>::min)())
+            {
+                // int 8 stores a 8-bit signed integer
+                action(static_cast<uint8_t>(msgpack_format::int8_cd), v);
+                action(static_cast<int8_t>(val),v);
+            }
+            else if (val >= (std::numeric_limits<int16_t>::min)())
+            {
+                // int 16 stores a 16-bit big-endian signed integer
+                action(static_cast<uint8_t>(msgpack_format::int16_cd), v);
+                action(static_cast<int16_t>(val),v);
+            }
+            else if (val >= (std::numeric_limits<int32_t>::min)())
+            {
+                // int 32 stores a 32-bit big-endian signed integer
+                action(static_cast<uint8_t>(msgpack_format::int32_cd), v);
+                action(static_cast<int32_t>(val),v);
+            }
+            else if (val >= (std::numeric_limits<int64_t>::min)())
+            {
+                // int 64 stores a 64-bit big-endian signed integer
+                action(static_cast<uint8_t>(msgpack_format::int64_cd), v);
+                action(static_cast<int64_t>(val),v);
+            }
+        }
+    }
+
+    template <class Action, class Result>
+    static void encode_uinteger(uint64_t val, Action action, Result& v)
+    {
+        if (val <= (std::numeric_limits<int8_t>::max)())
+        {
+            // positive fixnum stores 7-bit positive integer
+            action(static_cast<uint8_t>(val), v);
+        }
+        else if (val <= (std::numeric_limits<uint8_t>::max)())
+        {
+            // uint 8 stores a 8-bit unsigned integer
+            action(static_cast<uint8_t>(msgpack_format::uint8_cd), v);
+            action(static_cast<uint8_t>(val), v);
+        }
+        else if (val <= (std::numeric_limits<uint16_t>::max)())
+        {
+            // uint 16 stores a 16-bit big-endian unsigned integer
+            action(static_cast<uint8_t>(msgpack_format::uint16_cd), v);
+            action(static_cast<uint16_t>(val),v);
+        }
+        else if (val <= (std::numeric_limits<uint32_t>::max)())
+        {
+            // uint 32 stores a 32-bit big-endian unsigned integer
+            action(static_cast<uint8_t>(msgpack_format::uint32_cd), v);
+            action(static_cast<uint32_t>(val),v);
+        }
+        else if (val <= (std::numeric_limits<uint64_t>::max)())
+        {
+            // uint 64 stores a 64-bit big-endian unsigned integer
+            action(static_cast<uint8_t>(msgpack_format::uint64_cd), v);
+            action(static_cast<uint64_t>(val),v);
+        }
+    }
+
+    template <class Action, class Result>
+    static void encode_double(double val, Action action, Result& v)
+    {
+        // float 64
+        action(static_cast<uint8_t>(msgpack_format::float64_cd), v);
+        action(val,v);
+    }
+
+    template <class PackedArray, class Action, class Result>
+    static void encode_packed(const PackedArray& packed, Action action, Result& v)
+    {
+        const size_t length = packed.size();
+        switch (packed.type_id())
+        {
+        case json_type_tag::integer_t:
+            for (size_t i = 0; i < length; ++i)
+            {
+                encode_integer(packed.integer_at(i), action, v);
+            }
+            break;
+        case json_type_tag::uinteger_t:
+            for (size_t i = 0; i < length; ++i)
+            {
+                encode_uinteger(packed.uinteger_at(i), action, v);
+            }
+            break;
+        default:
+            for (size_t i = 0; i < length; ++i)
+            {
+                encode_double(packed.double_at(i), action, v);
+            }
+            break;
+        }
+    }
+
     template <class Action, class Result>
     static void encode(const Json& jval, Action action, Result& v)
     {
@@ -96,114 +234,19 @@ public:
 
             case json_type_tag::integer_t:
             {
-                int64_t val = jval.as_integer();
-                if (val >= 0)
-                {
-                    if (val <= (std::numeric_limits<int8_t>::max)())
-                    {
-                        // positive fixnum stores 7-bit positive integer
-                        action(static_cast<int8_t>(val),v);
-                    }
-                    else if (val <= (std::numeric_limits<uint8_t>::max)())
-                    {
-                        // uint 8 stores a 8-bit unsigned integer
-                        action(static_cast<uint8_t>(msgpack_format::uint8_cd), v);
-                        action(static_cast<uint8_t>(val),v);
-                    }
-                    else if (val <= (std::numeric_limits<uint16_t>::max)())
-                    {
-                        // uint 16 stores a 16-bit big-endian unsigned integer
-                        action(static_cast<uint8_t>(msgpack_format::uint16_cd), v);
-                        action(static_cast<uint16_t>(val),v);
-                    }
-                    else if (val <= (std::numeric_limits<uint32_t>::max)())
-                    {
-                        // uint 32 stores a 32-bit big-endian unsigned integer
-                        action(static_cast<uint8_t>(msgpack_format::uint32_cd), v);
-                        action(static_cast<uint32_t>(val),v);
-                    }
-                    else if (val <= (std::numeric_limits<int64_t>::max)())
-                    {
-                        // int 64 stores a 64-bit big-endian signed integer
-                        action(static_cast<uint8_t>(msgpack_format::int64_cd), v);
-                        action(static_cast<int64_t>(val),v);
-                    }
-                }
-                else
-                {
-                    if (val >= -32)
-                    {
-                        // negative fixnum stores 5-bit negative integer
-                        action(static_cast<int8_t>(val), v);
-                    }
-                    else if (val >= (std::numeric_limits<int8_t>::min)())
-                    {
-                        // int 8 stores a 8-bit signed integer
-                        action(static_cast<uint8_t>(msgpack_format::int8_cd), v);
-                        action(static_cast<int8_t>(val),v);
-                    }
-                    else if (val >= (std::numeric_limits<int16_t>::min)())
-                    {
-                        // int 16 stores a 16-bit big-endian signed integer
-                        action(static_cast<uint8_t>(msgpack_format::int16_cd), v);
-                        action(static_cast<int16_t>(val),v);
-                    }
-                    else if (val >= (std::numeric_limits<int32_t>::min)())
-                    {
-                        // int 32 stores a 32-bit big-endian signed integer
-                        action(static_cast<uint8_t>(msgpack_format::int32_cd), v);
-                        action(static_cast<int32_t>(val),v);
-                    }
-                    else if (val >= (std::numeric_limits<int64_t>::min)())
-                    {
-                        // int 64 stores a 64-bit big-endian signed integer
-                        action(static_cast<uint8_t>(msgpack_format::int64_cd), v);
-                        action(static_cast<int64_t>(val),v);
-                    }
-                }
+                encode_integer(jval.as_integer(), action, v);
                 break;
             }
 
-        case json_type_tag::uinteger_t:
+            case json_type_tag::uinteger_t:
             {
-                uint64_t val = jval.as_uinteger();
-                if (val <= (std::numeric_limits<int8_t>::max)())
-                {
-                    // positive fixnum stores 7-bit positive integer
-                    action(static_cast<uint8_t>(val), v);
-                }
-                else if (val <= (std::numeric_limits<uint8_t>::max)())
-                {
-                    // uint 8 stores a 8-bit unsigned integer
-                    action(static_cast<uint8_t>(msgpack_format::uint8_cd), v);
-                    action(static_cast<uint8_t>(val), v);
-                }
-                else if (val <= (std::numeric_limits<uint16_t>::max)())
-                {
-                    // uint 16 stores a 16-bit big-endian unsigned integer
-                    action(static_cast<uint8_t>(msgpack_format::uint16_cd), v);
-                    action(static_cast<uint16_t>(val),v);
-                }
-                else if (val <= (std::numeric_limits<uint32_t>::max)())
-                {
-                    // uint 32 stores a 32-bit big-endian unsigned integer
-                    action(static_cast<uint8_t>(msgpack_format::uint32_cd), v);
-                    action(static_cast<uint32_t>(val),v);
-                }
-                else if (val <= (std::numeric_limits<uint64_t>::max)())
-                {
-                    // uint 64 stores a 64-bit big-endian unsigned integer
-                    action(static_cast<uint8_t>(msgpack_format::uint64_cd), v);
-                    action(static_cast<uint64_t>(val),v);
-                }
+                encode_uinteger(jval.as_uinteger(), action, v);
                 break;
             }
 
             case json_type_tag::double_t:
             {
-                // float 64
-                action(static_cast<uint8_t>(msgpack_format::float64_cd), v);
-                action(jval.as_double(),v);
+                encode_double(jval.as_double(), action, v);
                 break;
             }
 
@@ -236,9 +279,16 @@ public:
                 }
 
                 // append each element
-                for (const auto& el : jval.array_range())
+                if (jval.array_value().is_packed())
+                {
+                    encode_packed(jval.array_value().packed(), action, v);
+                }
+                else
                 {
-                    encode(el, action, v);
+                    for (const auto& el : jval.array_range())
+                    {
+                        encode(el, action, v);
+                    }
                 }
                 break;
             }
@@ -0,0 +1,98 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <sstream>
+#include <vector>
+
+using namespace jsoncons;
+
+struct cow_policy : public sorted_policy
+{
+    static const bool copy_on_write = true;
+};
+
+struct cow_preserve_order_policy : public preserve_order_policy
+{
+    static const bool copy_on_write = true;
+};
+
+typedef basic_json<char,cow_policy> cow_json;
+typedef basic_json<char,cow_preserve_order_policy> cow_ojson;
+
+BOOST_AUTO_TEST_SUITE(copy_on_write_tests)
+
+BOOST_AUTO_TEST_CASE(test_is_copy_on_write_policy)
+{
+    BOOST_CHECK(!is_copy_on_write_policy<sorted_policy>::value);
+    BOOST_CHECK(!is_copy_on_write_policy<preserve_order_policy>::value);
+    BOOST_CHECK(is_copy_on_write_policy<cow_policy>::value);
+}
+
+BOOST_AUTO_TEST_CASE(test_copy_shares_structures)
+{
+    const cow_json a = cow_json::parse(R"({"config":{"limits":[1,2,3]},"users":[{"name":"a"},{"name":"b"}]})");
+    const cow_json b = a;
+
+    BOOST_CHECK(&a.object_value() == &b.object_value());
+    BOOST_CHECK(&a["users"].array_value() == &b["users"].array_value());
+    BOOST_CHECK(a == b);
+
+    const json c = json::parse(R"({"users":[{"name":"a"}]})");
+    const json d = c;
+    BOOST_CHECK(&c.object_value() != &d.object_value());
+}
+
+BOOST_AUTO_TEST_CASE(test_edit_copies_path)
+{
+    cow_json a = cow_json::parse(R"({"config":{"limits":[1,2,3],"name":"x"},"users":[{"name":"a"},{"name":"b"}]})");
+    cow_json b = a;
+
+    b["config"]["limits"][1] = 20;
+
+    BOOST_CHECK_EQUAL(2,a["config"]["limits"][1].as<int>());
+    BOOST_CHECK_EQUAL(20,b["config"]["limits"][1].as<int>());
+
+    const cow_json& ca = a;
+    const cow_json& cb = b;
+    BOOST_CHECK(&ca.object_value() != &cb.object_value());
+    BOOST_CHECK(&ca["config"].object_value() != &cb["config"].object_value());
+    BOOST_CHECK(&ca["config"]["limits"].array_value() != &cb["config"]["limits"].array_value());
+    // Subtrees off the edited path are still shared
+    BOOST_CHECK(&ca["users"].array_value() == &cb["users"].array_value());
+}
+
+BOOST_AUTO_TEST_CASE(test_copies_outlive_original)
+{
+    cow_json b;
+    cow_json c;
+    {
+        cow_json a = cow_json::parse(R"({"first":[1,2,3],"second":{"x":1}})");
+        b = a;
+        c = a;
+        a["first"].push_back(4);
+        BOOST_CHECK_EQUAL(4,a["first"].size());
+    }
+    BOOST_CHECK_EQUAL(3,b["first"].size());
+    c["second"]["y"] = 2;
+    BOOST_CHECK(!b["second"].has_key("y"));
+    BOOST_CHECK(c["second"].has_key("y"));
+}
+
+BOOST_AUTO_TEST_CASE(test_preserve_order_copy_on_write)
+{
+    cow_ojson a = cow_ojson::parse(R"({"b":1,"a":[1,2]})");
+    cow_ojson b = a;
+    b["c"] = 3;
+    b["a"].push_back(3);
+
+    BOOST_CHECK_EQUAL(std::string(R"({"b":1,"a":[1,2]})"),a.to_string());
+    BOOST_CHECK_EQUAL(std::string(R"({"b":1,"a":[1,2,3],"c":3})"),b.to_string());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,219 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/deferred_destructor.hpp>
+#include <string>
+
+using namespace jsoncons;
+
+struct cow_policy : public sorted_policy
+{
+    static const bool copy_on_write = true;
+};
+
+typedef basic_json<char,cow_policy> cow_json;
+
+namespace {
+
+const size_t deep = 500000;
+
+// Fails every allocation once allocations_left reaches zero, unless it is
+// negative, and counts the allocations not yet freed
+int64_t allocations_left = -1;
+int64_t live_allocations = 0;
+
+template <class T>
+struct failing_allocator
+{
+    typedef T value_type;
+
+    failing_allocator()
+    {
+    }
+
+    template <class U>
+    failing_allocator(const failing_allocator<U>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (allocations_left == 0)
+        {
+            throw std::bad_alloc();
+        }
+        if (allocations_left > 0)
+        {
+            --allocations_left;
+        }
+        ++live_allocations;
+        return static_cast<T*>(::operator new(n*sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        --live_allocations;
+        ::operator delete(p);
+    }
+
+    template <class U>
+    struct rebind
+    {
+        typedef failing_allocator<U> other;
+    };
+};
+
+template <class T, class U>
+bool operator==(const failing_allocator<T>&, const failing_allocator<U>&)
+{
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const failing_allocator<T>&, const failing_allocator<U>&)
+{
+    return false;
+}
+
+typedef basic_json<char,sorted_policy,failing_allocator<char>> failing_json;
+
+// Alternates arrays and objects, [{"a":[{"a":...}]}]
+template <class Json>
+Json make_deep(size_t depth)
+{
+    Json root = typename Json::array();
+    Json* p = &root;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        if (p->is_array())
+        {
+            p->push_back(Json());
+            p = &(*p)[0];
+        }
+        else
+        {
+            p->insert_or_assign("a", typename Json::array());
+            p = &(p->at("a"));
+        }
+    }
+    return root;
+}
+
+template <class Json>
+size_t depth_of(const Json& root)
+{
+    size_t depth = 0;
+    const Json* p = &root;
+    while (p->size() > 0)
+    {
+        const Json& first = p->is_array() ? (*p)[0] : p->at("a");
+        if (!first.is_array() && !first.is_object())
+        {
+            break;
+        }
+        p = &first;
+        ++depth;
+    }
+    return depth;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(deep_nesting_tests)
+
+BOOST_AUTO_TEST_CASE(test_deep_copy_and_destroy)
+{
+    json a = make_deep<json>(deep);
+    size_t depth = depth_of(a);
+    BOOST_CHECK_EQUAL(deep,depth);
+
+    json b = a;
+    BOOST_CHECK_EQUAL(depth,depth_of(b));
+
+    json c(a, std::allocator<char>());
+    BOOST_CHECK_EQUAL(depth,depth_of(c));
+
+    json d;
+    d = b;
+    BOOST_CHECK_EQUAL(depth,depth_of(d));
+}
+
+BOOST_AUTO_TEST_CASE(test_copy_preserves_values)
+{
+    json a = json::parse(R"({"a":[1,"two",{"b":[3.5,null,true,{"c":{}}]},[]],"d":{"e":"a string longer than short"}})");
+    json b = a;
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(a.to_string(),b.to_string());
+
+    ojson c = ojson::parse(R"({"z":[{"y":1,"x":2}],"w":{"v":[]}})");
+    ojson d = c;
+    BOOST_CHECK_EQUAL(std::string(R"({"z":[{"y":1,"x":2}],"w":{"v":[]}})"),d.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_copy_on_write_deep_destroy)
+{
+    cow_json a = make_deep<cow_json>(deep);
+    cow_json b = a;
+    b.push_back(1);
+    a = cow_json();
+    BOOST_CHECK_EQUAL(deep,depth_of(b));
+}
+
+BOOST_AUTO_TEST_CASE(test_destroy_without_memory)
+{
+    {
+        failing_json a = make_deep<failing_json>(1000);
+        failing_json b = failing_json::parse(R"({"a":[1,{"b":[2,3]},[]],"c":{"d":{}}})");
+        allocations_left = 0;
+    }
+    allocations_left = -1;
+    BOOST_CHECK_EQUAL(0,live_allocations);
+}
+
+BOOST_AUTO_TEST_CASE(test_copy_without_memory)
+{
+    failing_json a = failing_json::parse(R"({"a":[1,{"b":[2,"a string longer than short"]},[]],"c":{"d":{}}})");
+    int64_t before = live_allocations;
+    int64_t needed = 0;
+    {
+        failing_json b(a);
+        needed = live_allocations - before;
+    }
+    BOOST_CHECK(needed > 1);
+
+    // Fail at each allocation of the copy in turn
+    for (int64_t i = 0; i < needed; ++i)
+    {
+        allocations_left = i;
+        BOOST_CHECK_THROW(failing_json b(a),std::bad_alloc);
+        allocations_left = -1;
+        BOOST_CHECK_EQUAL(before,live_allocations);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_destructor)
+{
+    deferred_destructor destructor;
+
+    json a = make_deep<json>(deep);
+    json b = json::parse(R"({"a":[1,2,3],"b":{"c":"d"}})");
+    json c = 10;
+    destructor.destroy(std::move(a));
+    destructor.destroy(std::move(b));
+    destructor.destroy(std::move(c));
+    BOOST_CHECK(a.is_null());
+    BOOST_CHECK(b.is_null());
+    BOOST_CHECK(c.is_null());
+    destructor.wait();
+
+    json d = make_deep<json>(1000);
+    destructor.destroy(std::move(d));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -12,6 +12,8 @@
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <clocale>
+#include <cstdlib>
 
 using namespace jsoncons;
 
@@ -122,6 +124,52 @@ BOOST_AUTO_TEST_CASE(test_locale)
 }
 #endif
 
+BOOST_AUTO_TEST_CASE(test_double_to_string_precision)
+{
+    BOOST_CHECK(float_to_string<char>(0.1, 17) == std::string("0.10000000000000001"));
+    BOOST_CHECK(float_to_string<char>(0.1, 15) == std::string("0.1"));
+    BOOST_CHECK(float_to_string<char>(1234567.0, 7) == std::string("1234567.0"));
+    BOOST_CHECK(float_to_string<char>(1234567.0, 6) == std::string("1.23457e+06"));
+    BOOST_CHECK(float_to_string<char>(0.0001, 15) == std::string("0.0001"));
+    BOOST_CHECK(float_to_string<char>(0.00001, 15) == std::string("1.0e-05"));
+    BOOST_CHECK(float_to_string<char>(2.5, 1) == std::string("2.0"));
+    BOOST_CHECK(float_to_string<char>(-0.0, 15) == std::string("-0.0"));
+    BOOST_CHECK(float_to_string<char>(5e-324, 15) == std::string("4.94065645841247e-324"));
+    BOOST_CHECK(float_to_string<char>(1.7976931348623157e308, 17) == std::string("1.7976931348623157e+308"));
+    BOOST_CHECK(float_to_string<char>(1.0/3.0, 30) == std::string("0.333333333333333314829616256247"));
+}
+
+BOOST_AUTO_TEST_CASE(test_double_to_string_round_trip)
+{
+    double x = 1.0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        x = x * 1.7 + 0.3;
+        if (x > 1.0e300)
+        {
+            x = 1.0e-300;
+        }
+        std::string s = float_to_string<char>(x, 17);
+        BOOST_CHECK_EQUAL(x, std::strtod(s.c_str(), nullptr));
+        std::string t = float_to_string<char>(x, 15);
+        BOOST_CHECK_EQUAL(t, float_to_string<char>(std::strtod(t.c_str(), nullptr), 15));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_double_to_string_c_locale)
+{
+    // Output does not depend on the decimal point of the C locale
+    const char* loc = std::setlocale(LC_NUMERIC, "de_DE.UTF-8");
+    std::string s = float_to_string<char>(1.1, 17);
+    std::string t = float_to_string<char>(1.5, 3);
+    std::setlocale(LC_NUMERIC, "C");
+    if (loc != nullptr)
+    {
+        BOOST_CHECK(s == std::string("1.1000000000000001"));
+        BOOST_CHECK(t == std::string("1.5"));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_double_to_wstring)
 {
     double x = 1.0e100;
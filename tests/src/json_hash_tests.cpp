@@ -0,0 +1,106 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpatch/jsonpatch.hpp>
+#include <unordered_set>
+#include <unordered_map>
+#include <string>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_hash_tests)
+
+BOOST_AUTO_TEST_CASE(test_equal_values_hash_equal)
+{
+    BOOST_CHECK_EQUAL(json(1).hash_code(), json(1.0).hash_code());
+    BOOST_CHECK_EQUAL(json(uint64_t(1)).hash_code(), json(int64_t(1)).hash_code());
+    BOOST_CHECK_EQUAL(json(0.0).hash_code(), json(-0.0).hash_code());
+    BOOST_CHECK_EQUAL(json("a string that is not short").hash_code(), json(std::string("a string that is not short")).hash_code());
+
+    json a = json::parse(R"({"b":[1,2,{"c":null}],"a":"x"})");
+    ojson b = ojson::parse(R"({"a":"x","b":[1.0,2,{"c":null}]})");
+    ojson c = ojson::parse(R"({"b":[1,2,{"c":null}],"a":"x"})");
+    BOOST_CHECK(b == c);
+    BOOST_CHECK_EQUAL(b.hash_code(), c.hash_code());
+    BOOST_CHECK_EQUAL(a.hash_code(), json::parse(R"({"a":"x","b":[1,2.0,{"c":null}]})").hash_code());
+
+    json empty;
+    json empty2 = json::parse("{}");
+    BOOST_CHECK(empty == empty2);
+    BOOST_CHECK_EQUAL(empty.hash_code(), empty2.hash_code());
+}
+
+BOOST_AUTO_TEST_CASE(test_unequal_values_hash_differently)
+{
+    BOOST_CHECK(json(1).hash_code() != json(2).hash_code());
+    BOOST_CHECK(json("1").hash_code() != json(1).hash_code());
+    BOOST_CHECK(json::parse("[1,2]").hash_code() != json::parse("[2,1]").hash_code());
+    BOOST_CHECK(json::parse(R"({"a":1,"b":2})").hash_code() != json::parse(R"({"a":2,"b":1})").hash_code());
+    BOOST_CHECK(json::parse("[]").hash_code() != json::parse("{}").hash_code());
+    BOOST_CHECK(json(true).hash_code() != json(false).hash_code());
+}
+
+BOOST_AUTO_TEST_CASE(test_unordered_containers)
+{
+    std::unordered_set<json> set;
+    set.insert(json::parse(R"({"a":1,"b":[1,2]})"));
+    set.insert(json::parse(R"({"b":[1,2],"a":1.0})"));
+    set.insert(json::parse(R"({"a":2})"));
+    BOOST_CHECK_EQUAL(2,set.size());
+
+    std::unordered_map<json,std::string> map;
+    map[json::parse("[1,2,3]")] = "first";
+    map[json::parse("[1.0,2.0,3.0]")] = "second";
+    BOOST_CHECK_EQUAL(1,map.size());
+    BOOST_CHECK(map[json::parse("[1,2,3]")] == "second");
+}
+
+BOOST_AUTO_TEST_CASE(test_hash_follows_mutation)
+{
+    json a = json::parse(R"({"x":{"y":[1,2,3]},"z":1})");
+    json b = a;
+    size_t h = a.hash_code();
+    BOOST_CHECK_EQUAL(h, b.hash_code());
+    BOOST_CHECK(a == b);
+
+    b["x"]["y"][1] = 20;
+    BOOST_CHECK(b.hash_code() != h);
+    BOOST_CHECK(a != b);
+
+    b["x"]["y"][1] = 2;
+    BOOST_CHECK_EQUAL(h, b.hash_code());
+    BOOST_CHECK(a == b);
+
+    // Edits through a reference held across hash_code and == are seen
+    json& x = b.at("x");
+    BOOST_CHECK_EQUAL(h, b.hash_code());
+    x["w"] = 1;
+    BOOST_CHECK(b.hash_code() != h);
+    BOOST_CHECK(a != b);
+    a["x"]["w"] = 1;
+    BOOST_CHECK(a == b);
+    BOOST_CHECK_EQUAL(a.hash_code(), b.hash_code());
+}
+
+BOOST_AUTO_TEST_CASE(test_diff_after_hashing)
+{
+    json source = json::parse(R"({"a":[1,2,3],"b":{"c":"d"},"e":[{"f":1},{"g":2}]})");
+    json target = json::parse(R"({"a":[1,2,3],"b":{"c":"x"},"e":[{"f":1},{"g":2}]})");
+    BOOST_CHECK(source.hash_code() != target.hash_code());
+
+    json patch = jsonpatch::diff(source, target);
+    BOOST_REQUIRE(patch.size() == 1);
+    BOOST_CHECK(patch[0]["path"].as<std::string>() == "/b/c");
+
+    jsonpatch::patch(source, patch);
+    BOOST_CHECK(source == target);
+    BOOST_CHECK_EQUAL(source.hash_code(), target.hash_code());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,93 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_index.hpp>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_index_tests)
+
+BOOST_AUTO_TEST_CASE(test_index_find)
+{
+    json a = json::parse(R"([{"id":1,"name":"a"},{"id":2,"name":"b"},{"name":"c"},{"id":1.0,"name":"d"},10,{"id":"1","name":"e"}])");
+    json_index index(a,"id");
+
+    std::vector<const json*> found = index.find(1);
+    BOOST_REQUIRE_EQUAL(2,found.size());
+    BOOST_CHECK(found[0] == &a[0]);
+    BOOST_CHECK(found[1] == &a[3]);
+
+    BOOST_CHECK_EQUAL(1,index.count(2));
+    BOOST_CHECK_EQUAL(1,index.count("1"));
+    BOOST_CHECK_EQUAL(0,index.count(3));
+    BOOST_CHECK(index.positions(json::null()).empty());
+
+    BOOST_CHECK(index.field(a[2]) == nullptr);
+    BOOST_CHECK(index.field(a[4]) == nullptr);
+    BOOST_CHECK(index.field(a[1]) == &a[1].at("id"));
+}
+
+BOOST_AUTO_TEST_CASE(test_index_path)
+{
+    ojson a = ojson::parse(R"([{"address":{"city":"Toronto"}},{"address":{"city":"Montreal"}},{"address":"none"},{"address":{"city":"Toronto"}}])");
+    ojson_index index(a,std::vector<std::string>{"address","city"});
+
+    std::vector<size_t> positions = index.positions("Toronto");
+    BOOST_REQUIRE_EQUAL(2,positions.size());
+    BOOST_CHECK_EQUAL(0,positions[0]);
+    BOOST_CHECK_EQUAL(3,positions[1]);
+    BOOST_CHECK_EQUAL(1,index.count("Montreal"));
+
+    BOOST_CHECK_THROW(ojson_index(a,std::vector<std::string>{}),std::invalid_argument);
+    ojson o = ojson::object();
+    BOOST_CHECK_THROW(ojson_index(o,"id"),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_index_generation)
+{
+    json a = json::parse(R"([{"id":1},{"id":2}])");
+    json_index index(a,"id");
+    size_t generation = index.generation();
+    BOOST_CHECK(index.is_current());
+
+    a.push_back(json::parse(R"({"id":2})"));
+    BOOST_CHECK(!index.is_current());
+    BOOST_CHECK_EQUAL(1,index.count(2));
+    index.rebuild();
+    BOOST_CHECK(index.is_current());
+    BOOST_CHECK_EQUAL(2,index.count(2));
+    BOOST_CHECK(index.generation() > generation);
+
+    // Editing in place keeps the size, but not the modification count
+    a[0]["id"] = 3;
+    BOOST_CHECK(!index.is_current());
+    index.rebuild();
+    BOOST_CHECK(index.is_current());
+    BOOST_CHECK_EQUAL(1,index.count(3));
+    BOOST_CHECK_EQUAL(0,index.count(1));
+
+    // Const access leaves the index current
+    const json& c = a;
+    BOOST_CHECK_EQUAL(3,c[0]["id"].as<int>());
+    BOOST_CHECK(index.is_current());
+
+    generation = index.generation();
+    index.invalidate();
+    BOOST_CHECK(!index.is_current());
+    BOOST_CHECK(index.generation() > generation);
+
+    // Another array with the same elements is not the indexed one
+    index.rebuild();
+    a = json::parse(R"([{"id":3},{"id":2},{"id":2}])");
+    BOOST_CHECK(!index.is_current());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
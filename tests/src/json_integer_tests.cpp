@@ -62,5 +62,70 @@ BOOST_AUTO_TEST_CASE(test_integer_limits)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_integer_serialization)
+{
+    std::vector<int64_t> values = {0, 1, -1, 9, -9, 10, -10, 99, 100, -100, 999, 1000,
+                                   (std::numeric_limits<int64_t>::max)(),
+                                   (std::numeric_limits<int64_t>::min)()};
+    int64_t p = 1;
+    for (int i = 1; i < 19; ++i)
+    {
+        p *= 10;
+        values.push_back(p - 1);
+        values.push_back(p);
+        values.push_back(-p);
+        values.push_back(1 - p);
+    }
+    for (int64_t val : values)
+    {
+        std::ostringstream expected;
+        expected << val;
+        BOOST_CHECK_EQUAL(expected.str(), json(val).to_string());
+    }
+
+    std::vector<uint64_t> uvalues = {0, 1, 10, (std::numeric_limits<uint64_t>::max)()};
+    uint64_t q = 1;
+    for (int i = 1; i < 20; ++i)
+    {
+        q *= 10;
+        uvalues.push_back(q - 1);
+        uvalues.push_back(q);
+    }
+    for (uint64_t val : uvalues)
+    {
+        std::ostringstream expected;
+        expected << val;
+        BOOST_CHECK_EQUAL(expected.str(), json(val).to_string());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_integer_serialization_small_buffer)
+{
+    // Buffers shorter than the number, and numbers that straddle a flush
+    std::ostringstream os;
+    {
+        buffered_output<char> bo(os,4);
+        print_integer(int64_t(-12345), bo);
+        bo.put(',');
+        print_uinteger(uint64_t(987), bo);
+        bo.put(',');
+        print_integer(int64_t(42), bo);
+        bo.put(',');
+        print_integer((std::numeric_limits<int64_t>::min)(), bo);
+    }
+    BOOST_CHECK_EQUAL(std::string("-12345,987,42,-9223372036854775808"), os.str());
+
+    std::wostringstream wos;
+    {
+        buffered_output<wchar_t> bo(wos,3);
+        print_uinteger(uint64_t(7), bo);
+        bo.put(L',');
+        print_integer(int64_t(-70), bo);
+        bo.put(L',');
+        print_uinteger(uint64_t(18446744073709551615u), bo);
+    }
+    BOOST_CHECK(std::wstring(L"7,-70,18446744073709551615") == wos.str());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
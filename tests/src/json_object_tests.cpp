@@ -12,6 +12,67 @@
 
 using namespace jsoncons;
 
+namespace {
+
+// Fails every allocation once allocations_left reaches zero, unless it is
+// negative
+int64_t allocations_left = -1;
+
+template <class T>
+struct limited_allocator
+{
+    typedef T value_type;
+
+    limited_allocator()
+    {
+    }
+
+    template <class U>
+    limited_allocator(const limited_allocator<U>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (allocations_left == 0)
+        {
+            throw std::bad_alloc();
+        }
+        if (allocations_left > 0)
+        {
+            --allocations_left;
+        }
+        return static_cast<T*>(::operator new(n*sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        ::operator delete(p);
+    }
+
+    template <class U>
+    struct rebind
+    {
+        typedef limited_allocator<U> other;
+    };
+};
+
+template <class T, class U>
+bool operator==(const limited_allocator<T>&, const limited_allocator<U>&)
+{
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const limited_allocator<T>&, const limited_allocator<U>&)
+{
+    return false;
+}
+
+typedef basic_json<char,sorted_policy,limited_allocator<char>> limited_json;
+
+}
+
 BOOST_AUTO_TEST_SUITE(json_object_tests)
 
 BOOST_AUTO_TEST_CASE(as_test)
@@ -1079,6 +1140,31 @@ const json expected = json::parse(R"(
     //std::cout << j << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(test_merge_failure_leaves_object_unchanged)
+{
+    const limited_json original = limited_json::parse(R"({"a":"a string longer than short","c":[1,2],"e":{"f":3}})");
+    const limited_json source = limited_json::parse(R"({"a":1,"b":"another string longer than short","d":[4,5]})");
+
+    // Fail at each allocation in turn until the merge succeeds
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        limited_json j = original;
+        allocations_left = i;
+        try
+        {
+            j.merge_or_update(source);
+            allocations_left = -1;
+            BOOST_CHECK_EQUAL(limited_json::parse(R"({"a":1,"b":"another string longer than short","c":[1,2],"d":[4,5],"e":{"f":3}})"),j);
+            break;
+        }
+        catch (const std::bad_alloc&)
+        {
+            allocations_left = -1;
+            BOOST_CHECK_EQUAL(original,j);
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(test_ojson_merge_or_update)
 {
 ojson j = ojson::parse(R"(
@@ -1193,5 +1279,55 @@ ojson expected = ojson::parse(R"(
     //std::cout << "(2)\n" << source << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(test_json_merge_or_update_move_interleaved)
+{
+    json j = json::parse(R"({"a":1,"c":3,"e":5})");
+    json source = json::parse(R"({"b":20,"c":30,"f":60})");
+
+    j.merge_or_update(std::move(source));
+    BOOST_CHECK_EQUAL(json::parse(R"({"a":1,"b":20,"c":30,"e":5,"f":60})"),j);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_merge_large)
+{
+    json a;
+    json b;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        a["k" + std::to_string(2*i)] = i;
+        b["k" + std::to_string(3*i)] = -1;
+    }
+    json merged = a;
+    merged.merge(b);
+    json updated = a;
+    updated.merge_or_update(b);
+
+    BOOST_CHECK_EQUAL(1000 + 1000 - 334,merged.size());
+    BOOST_CHECK_EQUAL(merged.size(),updated.size());
+    BOOST_CHECK_EQUAL(3,merged["k6"].as<int>());
+    BOOST_CHECK_EQUAL(-1,updated["k6"].as<int>());
+    BOOST_CHECK_EQUAL(-1,merged["k3"].as<int>());
+    BOOST_CHECK_EQUAL(1,updated["k2"].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_json_erase_keys)
+{
+    json j = json::parse(R"({"a":1,"b":2,"c":3,"d":4,"e":5})");
+    std::vector<std::string> keys = {"e","b","x","a"};
+    j.erase_keys(keys.begin(),keys.end());
+    BOOST_CHECK_EQUAL(json::parse(R"({"c":3,"d":4})"),j);
+
+    ojson k = ojson::parse(R"({"e":5,"b":2,"c":3,"a":1,"d":4})");
+    k.erase_keys(keys.begin(),keys.end());
+    BOOST_CHECK_EQUAL(std::string(R"({"c":3,"d":4})"),k.to_string());
+
+    json empty;
+    empty.erase_keys(keys.begin(),keys.end());
+    BOOST_CHECK(empty.size() == 0);
+
+    json array = json::array();
+    BOOST_CHECK_THROW(array.erase_keys(keys.begin(),keys.end()),std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,111 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/counting_allocator.hpp>
+#include <string>
+
+using namespace jsoncons;
+
+namespace {
+
+struct proxy_tag {};
+
+typedef basic_json<char,sorted_policy,counting_allocator<char,proxy_tag>> counted_json;
+
+}
+
+BOOST_AUTO_TEST_SUITE(json_proxy_tests)
+
+BOOST_AUTO_TEST_CASE(test_chained_read_does_not_allocate)
+{
+    counted_json j = counted_json::parse(R"({"a member name longer than short":{"another long member name":{"a third long member name":10}}})");
+    const std::string a = "a member name longer than short";
+    const std::string b = "another long member name";
+    const std::string c = "a third long member name";
+
+    allocation_statistics& stats = counting_allocator<char,proxy_tag>::statistics();
+    stats.reset();
+    BOOST_CHECK_EQUAL(10,j[a][b][c].as<int>());
+    BOOST_CHECK(j[a][b].has_key(c));
+    BOOST_CHECK(j[a][b][c].is_integer());
+    j[a][b][c] = 20;
+    BOOST_CHECK_EQUAL(0,stats.allocations());
+    BOOST_CHECK_EQUAL(20,j[a][b][c].as<int>());
+
+    j[a][b]["a new member name that is long"] = 30;
+    BOOST_CHECK(stats.allocations() > 0);
+    BOOST_CHECK_EQUAL(30,j[a][b]["a new member name that is long"].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_creates_members)
+{
+    json j;
+    j["a"]["b"]["c"] = 1;
+    j["a"]["d"] = json::array();
+    j["a"]["d"].push_back(2);
+    j["a"]["b"]["e"] = j["a"]["b"]["c"];
+    BOOST_CHECK_EQUAL(json::parse(R"({"a":{"b":{"c":1,"e":1},"d":[2]}})"),j);
+
+    std::string name = "f";
+    j[name] = "value";
+    name = "g";
+    j[name] = j["f"];
+    BOOST_CHECK(j["g"].as<std::string>() == "value");
+
+    BOOST_CHECK_THROW(j["missing"].as<int>(),std::out_of_range);
+    BOOST_CHECK(!j.has_key("missing"));
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_reuse)
+{
+    json j = json::parse(R"({"a":{"b":1}})");
+    auto p = j["a"];
+    BOOST_CHECK(p.is_object());
+    p["c"] = 2;
+    p["b"] = 3;
+    BOOST_CHECK_EQUAL(2,p.size());
+    BOOST_CHECK_EQUAL(json::parse(R"({"a":{"b":3,"c":2}})"),j);
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_after_sibling_inserts)
+{
+    // Inserting members moves the others, so a held proxy must find its
+    // member again
+    json j = json::parse(R"({"m":{"v":1}})");
+    auto p = j["m"];
+    BOOST_CHECK_EQUAL(1,p["v"].as<int>());
+    for (int i = 0; i < 100; ++i)
+    {
+        j["k" + std::to_string(i)] = i;
+    }
+    p["v"] = 2;
+    BOOST_CHECK_EQUAL(2,j["m"]["v"].as<int>());
+    BOOST_CHECK_EQUAL(101,j.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_proxy_temporary_key)
+{
+    // Keys that are temporaries are used within the full expression
+    json j;
+    std::string prefix = "member ";
+    j[prefix + "a long enough name to allocate"][std::string("b")][prefix + "c"] = 1;
+    j[prefix + "a long enough name to allocate"][std::string("b")][prefix + "d"] = 2;
+    BOOST_CHECK_EQUAL(1,j[prefix + "a long enough name to allocate"][std::string("b")][prefix + "c"].as<int>());
+    BOOST_CHECK_EQUAL(2,j[std::string("member a long enough name to allocate")]["b"].size());
+    BOOST_CHECK(j[prefix + "a long enough name to allocate"][std::string("b")].has_key(prefix + "d"));
+
+    // To keep a proxy, keep its key
+    std::string key = prefix + "a long enough name to allocate";
+    auto p = j[key];
+    p["e"] = 3;
+    BOOST_CHECK_EQUAL(3,j.at(key).at("e").as<int>());
+    BOOST_CHECK_EQUAL(json::parse(R"({"member a long enough name to allocate":{"b":{"member c":1,"member d":2},"e":3}})"),j);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -214,6 +214,118 @@ BOOST_AUTO_TEST_CASE(test_serialization_1)
     BOOST_CHECK_EQUAL(expected7,os7.str());
 }
 
+BOOST_AUTO_TEST_CASE(test_escape_string_runs)
+{
+    // Each escaped character at each position of a plain string, so that it
+    // falls at every offset within and across the blocks that are scanned
+    struct escape_case
+    {
+        std::string input;
+        std::string escaped;
+        bool escape_solidus;
+        bool escape_all_non_ascii;
+    };
+    std::vector<escape_case> cases = {
+        {"\"", "\\\"", false, false},
+        {"\\", "\\\\", false, false},
+        {"\n", "\\n", false, false},
+        {"\t", "\\t", false, false},
+        {std::string(1,'\x01'), "\\u0001", false, false},
+        {std::string(1,'\x1f'), "\\u001F", false, false},
+        {std::string(1,'\x7f'), "\\u007F", false, false},
+        {"/", "/", false, false},
+        {"/", "\\/", true, false},
+        {"\xC3\xA9", "\xC3\xA9", false, false},
+        {"\xC3\xA9", "\\u00E9", false, true},
+        {"\xF0\x90\x80\x81", "\\uD800\\uDC01", false, true}
+    };
+    for (const auto& c : cases)
+    {
+        serialization_options options;
+        options.escape_solidus(c.escape_solidus);
+        options.escape_all_non_ascii(c.escape_all_non_ascii);
+        for (size_t length = 0; length <= 40; ++length)
+        {
+            for (size_t pos = 0; pos <= length; ++pos)
+            {
+                std::string s = std::string(pos,'a') + c.input + std::string(length - pos,'~');
+                std::string expected = "\"" + std::string(pos,'a') + c.escaped + std::string(length - pos,'~') + "\"";
+                std::string output;
+                json(s).dump(output,options);
+                BOOST_CHECK_EQUAL(expected, output);
+            }
+        }
+    }
+
+    std::string plain(100,'x');
+    std::string output;
+    json(plain).dump(output);
+    BOOST_CHECK_EQUAL("\"" + plain + "\"", output);
+}
+
+BOOST_AUTO_TEST_CASE(test_wide_escape_string_runs)
+{
+    std::wstring s = std::wstring(20,L'a') + L"\"\\\n" + std::wstring(20,L'b') + L"/\x7f";
+    wserialization_options options;
+    options.escape_solidus(true);
+    std::wstring output;
+    wjson(s).dump(output,options);
+    BOOST_CHECK(L"\"" + std::wstring(20,L'a') + L"\\\"\\\\\\n" + std::wstring(20,L'b') + L"\\/\\u007F\"" == output);
+}
+
+BOOST_AUTO_TEST_CASE(test_cache_escaped_keys)
+{
+    // Repeated names, names that need escaping, more distinct names than
+    // the cache holds, and names longer than are cached
+    std::vector<std::string> names = {"id", "name", "quote\"d", "line\nbreak", "", "caf\xC3\xA9", std::string(100,'k')};
+    for (size_t i = 0; i < 200; ++i)
+    {
+        names.push_back("key" + std::to_string(i));
+    }
+
+    json a = json::array();
+    ojson oa = ojson::array();
+    for (size_t i = 0; i < 50; ++i)
+    {
+        json record;
+        ojson orecord;
+        for (size_t k = 0; k < names.size(); k += 1 + i % 5)
+        {
+            record[names[k]] = k;
+            orecord[names[(names.size() - 1 - k)]] = k;
+        }
+        a.push_back(std::move(record));
+        oa.push_back(std::move(orecord));
+    }
+
+    for (bool pprint : {false, true})
+    {
+        serialization_options options;
+        options.escape_all_non_ascii(true);
+        serialization_options cached = options;
+        cached.cache_escaped_keys(true);
+
+        std::ostringstream expected;
+        a.dump(expected, options, pprint);
+        std::ostringstream actual;
+        a.dump(actual, cached, pprint);
+        BOOST_CHECK_EQUAL(expected.str(), actual.str());
+
+        std::ostringstream oexpected;
+        oa.dump(oexpected, options, pprint);
+        std::ostringstream oactual;
+        oa.dump(oactual, cached, pprint);
+        BOOST_CHECK_EQUAL(oexpected.str(), oactual.str());
+    }
+
+    wjson w = wjson::parse(L"[{\"a\":1,\"b\\\"\":2},{\"a\":3,\"b\\\"\":4}]");
+    wserialization_options woptions;
+    woptions.cache_escaped_keys(true);
+    std::wostringstream wos;
+    w.dump(wos, woptions);
+    BOOST_CHECK(wos.str() == L"[{\"a\":1,\"b\\\"\":2},{\"a\":3,\"b\\\"\":4}]");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
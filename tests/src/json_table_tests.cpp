@@ -0,0 +1,161 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_table.hpp>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_table_tests)
+
+BOOST_AUTO_TEST_CASE(test_table_round_trip)
+{
+    json records = json::parse(R"([{"id":1,"name":"a","price":1.5,"tags":["x"]},{"id":2,"name":"b","price":2.25,"tags":[]},{"id":3,"name":"c","price":3,"tags":null}])");
+    json_table table(records);
+    BOOST_CHECK(table.is_columnar());
+    BOOST_CHECK_EQUAL(3,table.size());
+    BOOST_REQUIRE_EQUAL(4,table.keys().size());
+    BOOST_CHECK(table.keys()[0] == "id");
+    BOOST_CHECK_EQUAL(records,table.to_json());
+
+    BOOST_CHECK_EQUAL(4,table[1].size());
+    BOOST_CHECK(table[1].has_key("name"));
+    BOOST_CHECK(!table[1].has_key("missing"));
+    BOOST_CHECK(table[1]["name"].as<std::string>() == "b");
+    BOOST_CHECK_EQUAL(records[2],table[2].to_json());
+    BOOST_CHECK_THROW(table[0].at("missing"),std::out_of_range);
+
+    ojson orecords = ojson::parse(R"([{"b":1,"a":"x"},{"b":2,"a":"y"}])");
+    ojson_table otable(orecords);
+    BOOST_CHECK(otable.keys()[0] == "b");
+    BOOST_CHECK_EQUAL(orecords,otable.to_json());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_assignment)
+{
+    json_table table(json::parse(R"([{"id":1,"price":1.5},{"id":2,"price":2.5}])"));
+    table[0]["price"] = 4.5;
+    table[1]["id"] = 10;
+    BOOST_CHECK(table.is_columnar());
+    BOOST_CHECK_EQUAL(json::parse(R"([{"id":1,"price":4.5},{"id":10,"price":2.5}])"),table.to_json());
+
+    // A value of another type is kept, the column is no longer packed
+    table[1]["id"] = "ten";
+    BOOST_CHECK(table.is_columnar());
+    BOOST_CHECK(table[1]["id"].as<std::string>() == "ten");
+    BOOST_CHECK_EQUAL(1,table[0]["id"].as<int>());
+
+    // A member outside the schema converts the table
+    table[0]["extra"] = true;
+    BOOST_CHECK(!table.is_columnar());
+    BOOST_CHECK_EQUAL(json::parse(R"([{"extra":true,"id":1,"price":4.5},{"id":"ten","price":2.5}])"),table.to_json());
+}
+
+BOOST_AUTO_TEST_CASE(test_schema_violation)
+{
+    json records = json::parse(R"([{"id":1,"name":"a"},{"id":2,"name":"b"},{"id":3},5,{"id":4,"name":"d"}])");
+    json_table table;
+    table.push_back(records[0]);
+    table.push_back(records[1]);
+    BOOST_CHECK(table.is_columnar());
+    table.push_back(records[2]);
+    BOOST_CHECK(!table.is_columnar());
+    BOOST_CHECK(table.keys().empty());
+    table.push_back(records[3]);
+    table.push_back(records[4]);
+    BOOST_CHECK_EQUAL(5,table.size());
+    BOOST_CHECK_EQUAL(records,table.to_json());
+    BOOST_CHECK_EQUAL(10,table.sum<int>("id"));
+
+    BOOST_CHECK_THROW(json_table(json::object()),std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_column_scans)
+{
+    json records = json::array();
+    for (int i = 0; i < 100; ++i)
+    {
+        json record;
+        record["id"] = i;
+        record["score"] = i * 0.5;
+        record["active"] = i % 2 == 0;
+        records.push_back(record);
+    }
+    json_table table(records);
+    BOOST_CHECK_EQUAL(4950,table.sum<int64_t>("id"));
+    BOOST_CHECK_EQUAL(2475.0,table.sum<double>("score"));
+
+    std::vector<size_t> found = table.filter<double>("score",[](double x){return x >= 49.0;});
+    BOOST_REQUIRE_EQUAL(2,found.size());
+    BOOST_CHECK_EQUAL(98,found[0]);
+    BOOST_CHECK_EQUAL(99,found[1]);
+    BOOST_CHECK_EQUAL(50,table.filter<bool>("active",[](bool b){return b;}).size());
+    BOOST_CHECK(table.filter<int>("missing",[](int){return true;}).empty());
+
+    BOOST_CHECK(table.memory_footprint().total_bytes() < records.memory_footprint().total_bytes());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_iteration)
+{
+    json records = json::parse(R"([{"id":1,"name":"a"},{"id":2,"name":"b"}])");
+    json_table table(records);
+
+    // Rows and members in both representations
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        json result = json::array();
+        for (auto row : table.array_range())
+        {
+            json obj;
+            for (const auto& member : row.object_range())
+            {
+                obj.insert_or_assign(member.key(),member.value());
+            }
+            result.push_back(obj);
+        }
+        BOOST_CHECK_EQUAL(records,result);
+
+        const json_table& ctable = table;
+        size_t count = 0;
+        for (auto row : ctable.array_range())
+        {
+            count += row.size();
+        }
+        BOOST_CHECK_EQUAL(pass == 0 ? 4 : 5,count);
+
+        table.push_back(json::parse(R"({"other":true})"));
+        records.push_back(json::parse(R"({"other":true})"));
+    }
+    BOOST_CHECK(!table.is_columnar());
+
+    for (auto row : table.array_range())
+    {
+        row["id"] = 0;
+    }
+    BOOST_CHECK_EQUAL(0,table[3]["id"].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_table_bounds)
+{
+    json_table table(json::parse(R"([{"id":1},{"id":2}])"));
+    BOOST_CHECK_THROW(table.at(2,"id"),std::out_of_range);
+    BOOST_CHECK_THROW(table[2]["id"].as<int>(),std::out_of_range);
+    BOOST_CHECK_THROW(table.set(2,"id",json(3)),std::out_of_range);
+    BOOST_CHECK_THROW(table.row_members(2),std::out_of_range);
+
+    table.push_back(json("not an object"));
+    BOOST_CHECK(!table.is_columnar());
+    BOOST_CHECK_THROW(table.at(3,"id"),std::out_of_range);
+    BOOST_CHECK_THROW(table.set(3,"id",json(3)),std::out_of_range);
+    BOOST_CHECK_THROW(table.row_to_json(3),std::out_of_range);
+    BOOST_CHECK_EQUAL(2,table.at(1,"id").as<int>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
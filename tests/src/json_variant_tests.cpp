@@ -213,5 +213,15 @@ BOOST_AUTO_TEST_CASE(test_equals)
     BOOST_CHECK(var17 == var16);
 }
 
+BOOST_AUTO_TEST_CASE(test_variant_size)
+{
+    // The type tag shares the first word with the small string length 
+    // and the double precision, so every value fits in two words
+    BOOST_CHECK_EQUAL(sizeof(json::variant), 2*sizeof(double));
+    BOOST_CHECK_EQUAL(sizeof(json), 2*sizeof(double));
+    BOOST_CHECK_EQUAL(sizeof(wjson), 2*sizeof(double));
+    BOOST_CHECK_EQUAL(sizeof(ojson), 2*sizeof(double));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
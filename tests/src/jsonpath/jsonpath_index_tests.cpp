@@ -0,0 +1,84 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_index.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(jsonpath_index_tests)
+
+BOOST_AUTO_TEST_CASE(test_indexed_filter_matches_scan)
+{
+    json root = json::parse(R"(
+    {"books":[{"category":"fiction","title":"A","price":8,"info":{"lang":"en"}},
+              {"category":"reference","title":"B","price":10,"info":{"lang":"fr"}},
+              {"title":"C","price":8.0},
+              {"category":"fiction","title":"D","price":12,"info":{"lang":"en"}}]}
+    )");
+    const json& books = root.at("books");
+    json_index by_category(books,"category");
+    json_index by_price(books,"price");
+    json_index by_lang(books,std::vector<std::string>{"info","lang"});
+    std::vector<const json_index*> indexes = {&by_category,&by_price,&by_lang};
+
+    std::vector<std::string> paths = {
+        "$.books[?(@.category == 'fiction')]",
+        "$.books[?('fiction' == @.category)]",
+        "$.books[?(@['category'] == 'reference')]",
+        "$.books[?(@.price == 8)]",
+        "$.books[?(@.info.lang == 'en')]",
+        "$.books[?(@.category == 'none')]",
+        "$.books[?(@.category == 'fiction' && @.price == 12)]",
+        "$.books[?(@.price == 10)].title"
+    };
+    for (const auto& path : paths)
+    {
+        BOOST_CHECK_EQUAL(json_query(root,path),json_query(root,path,indexes));
+        BOOST_CHECK_EQUAL(json_query(root,path,result_type::path),json_query(root,path,indexes,result_type::path));
+    }
+    BOOST_CHECK_EQUAL(2,json_query(root,"$.books[?(@.price == 8)]",indexes).size());
+}
+
+BOOST_AUTO_TEST_CASE(test_index_is_used_only_when_current)
+{
+    json root = json::parse(R"({"items":[{"id":1},{"id":2}]})");
+    json& items = root.at("items");
+    json_index index(items,"id");
+    std::vector<const json_index*> indexes = {&index};
+
+    BOOST_CHECK_EQUAL(1,json_query(root,"$.items[?(@.id == 1)]",indexes).size());
+
+    // The entries are stale after an edit in place, so the filter is
+    // evaluated on every element
+    items[1]["id"] = 1;
+    BOOST_CHECK(!index.is_current());
+    BOOST_CHECK_EQUAL(2,json_query(root,"$.items[?(@.id == 1)]",indexes).size());
+    BOOST_CHECK_EQUAL(2,json_query(root,"$.items[?(@.id == 1)]").size());
+
+    json_replace(root,"$.items[0].id",2);
+    index.rebuild();
+    BOOST_CHECK_EQUAL(1,json_query(root,"$.items[?(@.id == 1)]",indexes).size());
+    json_replace(root,"$.items[0].id",1);
+    BOOST_CHECK_EQUAL(2,json_query(root,"$.items[?(@.id == 1)]",indexes).size());
+
+    index.invalidate();
+    BOOST_CHECK_EQUAL(2,json_query(root,"$.items[?(@.id == 1)]",indexes).size());
+    index.rebuild();
+    BOOST_CHECK_EQUAL(2,json_query(root,"$.items[?(@.id == 1)]",indexes).size());
+
+    items.push_back(json::parse(R"({"id":1})"));
+    BOOST_CHECK_EQUAL(3,json_query(root,"$.items[?(@.id == 1)]",indexes).size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,118 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/lazy_json.hpp>
+#include <string>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(lazy_json_tests)
+
+BOOST_AUTO_TEST_CASE(test_lazy_access)
+{
+    const std::string s = R"(
+    {
+        "name" : "config",
+        "servers" : [{"host":"a","port":80},{"host":"b","port":8080,"tags":["x]","y}"]}],
+        "limits" : {"max" : 10.5, "enabled" : true, "none" : null},
+        "quoted\"key" : -1
+    }
+    )";
+    lazy_json doc = lazy_json::parse(s);
+    BOOST_CHECK(doc.is_object());
+    BOOST_CHECK_EQUAL(4,doc.size());
+    BOOST_CHECK(doc["name"].as<std::string>() == "config");
+    BOOST_CHECK(doc["servers"].is_array());
+    BOOST_CHECK_EQUAL(2,doc["servers"].size());
+    BOOST_CHECK_EQUAL(8080,doc["servers"][1]["port"].as<int>());
+    BOOST_CHECK(doc["servers"][1]["tags"][1].as<std::string>() == "y}");
+    BOOST_CHECK(doc["limits"]["enabled"].as<bool>());
+    BOOST_CHECK(doc["limits"]["none"].is_null());
+    BOOST_CHECK(doc["limits"]["max"].is_number());
+    BOOST_CHECK(doc["limits"]["max"].is<double>());
+    BOOST_CHECK_EQUAL(-1,doc["quoted\"key"].as<int>());
+    BOOST_CHECK(doc.has_key("limits"));
+    BOOST_CHECK(!doc.has_key("missing"));
+
+    BOOST_CHECK_THROW(doc.at("missing"),std::out_of_range);
+    BOOST_CHECK_THROW(doc["servers"].at(2),std::out_of_range);
+    BOOST_CHECK_THROW(doc["name"]["x"],std::runtime_error);
+
+    BOOST_CHECK_EQUAL(json::parse(s),doc.value());
+    BOOST_CHECK_EQUAL(json::parse(s)["servers"],doc["servers"].value());
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_on_access)
+{
+    lazy_json doc = lazy_json::parse(R"({"a":{"b":[1,2,3]},"c":{"d":"e"}})");
+    lazy_json a = doc["a"];
+    BOOST_CHECK(!a.is_parsed());
+    BOOST_CHECK(a.raw() == R"({"b":[1,2,3]})");
+    BOOST_CHECK_EQUAL(6,a["b"].value()[0].as<int>() + a["b"][1].as<int>() + a["b"][2].as<int>());
+    BOOST_CHECK(a["b"].is_parsed());
+    BOOST_CHECK(!a.is_parsed());
+    BOOST_CHECK(!doc["c"].is_parsed());
+    BOOST_CHECK(!doc.is_parsed());
+}
+
+BOOST_AUTO_TEST_CASE(test_member_order)
+{
+    lazy_json doc = lazy_json::parse(R"({"z":1,"a":2,"m":3,"a":4})");
+    const auto& members = doc.members();
+    BOOST_REQUIRE_EQUAL(4,members.size());
+    BOOST_CHECK(members[0].key == "z");
+    BOOST_CHECK(members[2].key == "m");
+    BOOST_CHECK_EQUAL(4,doc["a"].as<int>());
+    BOOST_CHECK_EQUAL(json::parse(R"({"z":1,"a":2,"m":3,"a":4})")["a"],doc["a"].value());
+
+    lazy_json arr = lazy_json::parse("[]");
+    BOOST_CHECK_EQUAL(0,arr.size());
+    BOOST_CHECK(arr.elements().empty());
+    BOOST_CHECK_EQUAL(0,lazy_json::parse("{ }").size());
+}
+
+BOOST_AUTO_TEST_CASE(test_lazy_errors)
+{
+    BOOST_CHECK_THROW(lazy_json::parse(""),parse_error);
+    BOOST_CHECK_THROW(lazy_json::parse("{\"a\":1} x"),parse_error);
+    BOOST_CHECK_THROW(lazy_json::parse("{\"a\":[1,2}"),parse_error);
+    BOOST_CHECK_THROW(lazy_json::parse("{\"a\":\"1}"),parse_error);
+
+    // Errors are found when the subtree is read
+    lazy_json doc = lazy_json::parse("{\"a\":1,\n\"b\":[1,\n tru]}");
+    BOOST_CHECK_EQUAL(1,doc["a"].as<int>());
+    try
+    {
+        doc["b"].value();
+        BOOST_FAIL("Expected parse_error");
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK_EQUAL(3,e.line_number());
+        BOOST_CHECK_EQUAL(2,e.column_number());
+    }
+
+    lazy_json bad = lazy_json::parse("{\"a\" 1}");
+    BOOST_CHECK_THROW(bad["a"],parse_error);
+
+    // No text
+    lazy_json empty;
+    BOOST_CHECK_THROW(empty.is_object(),std::runtime_error);
+    BOOST_CHECK_THROW(empty.raw(),std::runtime_error);
+    BOOST_CHECK_THROW(empty.size(),std::runtime_error);
+    BOOST_CHECK_THROW(empty["a"],std::runtime_error);
+    BOOST_CHECK_THROW(empty.value(),std::runtime_error);
+
+    lazy_json moved = std::move(doc);
+    BOOST_CHECK_EQUAL(1,moved["a"].as<int>());
+    BOOST_CHECK_THROW(doc.is_parsed(),std::runtime_error);
+    BOOST_CHECK_THROW(doc[0],std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,99 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/counting_allocator.hpp>
+#include <string>
+
+using namespace jsoncons;
+
+namespace {
+
+struct footprint_tag {};
+
+typedef basic_json<char,sorted_policy,counting_allocator<char,footprint_tag>> counted_json;
+typedef basic_json<char,preserve_order_policy,counting_allocator<char,footprint_tag>> counted_ojson;
+
+struct cow_policy : public sorted_policy
+{
+    static const bool copy_on_write = true;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(memory_footprint_tests)
+
+BOOST_AUTO_TEST_CASE(test_scalar_footprint)
+{
+    BOOST_CHECK_EQUAL(0,json().memory_footprint().total_bytes());
+    BOOST_CHECK_EQUAL(0,json(10).memory_footprint().total_bytes());
+    BOOST_CHECK_EQUAL(0,json("short").memory_footprint().total_bytes());
+
+    json s("a string that is too long to be kept in the value");
+    json_memory_footprint footprint = s.memory_footprint();
+    BOOST_CHECK(footprint.string_bytes > s.as_string_view().length());
+    BOOST_CHECK_EQUAL(footprint.string_bytes,footprint.total_bytes());
+}
+
+BOOST_AUTO_TEST_CASE(test_structure_footprint)
+{
+    json j = json::parse(R"({"a long member name, not short":[1,2,3],"b":{"c":"a string that is too long to be short"}})");
+    json_memory_footprint footprint = j.memory_footprint();
+    BOOST_CHECK(footprint.string_bytes > 0);
+    BOOST_CHECK(footprint.key_bytes > 0);
+    BOOST_CHECK(footprint.array_bytes >= sizeof(json::array) + 3*sizeof(json));
+    BOOST_CHECK(footprint.object_bytes >= 2*sizeof(json::object) + 3*sizeof(json::key_value_pair_type));
+
+    json_memory_footprint sum = j["a long member name, not short"].memory_footprint();
+    sum += j["b"].memory_footprint();
+    BOOST_CHECK_EQUAL(footprint.array_bytes,sum.array_bytes);
+    BOOST_CHECK_EQUAL(footprint.string_bytes,sum.string_bytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_footprint_matches_allocations)
+{
+    const std::string s = R"({"name":"a string that is too long to be short","tags":["x","a string that is too long to be short"],)"
+                          R"("members":{"a member name that is long":1,"b":[true,false,null]},"numbers":[1.5,2.5,3.5]})";
+
+    allocation_statistics& stats = counting_allocator<char,footprint_tag>::statistics();
+    {
+        counted_json j = counted_json::parse(s);
+        stats.reset();
+        counted_json k = j;
+        BOOST_CHECK_EQUAL(stats.live_bytes(),k.memory_footprint().total_bytes());
+        BOOST_CHECK_EQUAL(stats.live_bytes(),j.memory_footprint().total_bytes());
+        BOOST_CHECK(stats.allocations() > 0);
+        BOOST_CHECK(stats.peak_bytes() >= stats.live_bytes());
+    }
+
+    stats.reset();
+    {
+        counted_ojson j = counted_ojson::parse(s);
+        BOOST_CHECK(stats.allocations() > 0);
+        BOOST_CHECK(stats.live_bytes() >= j.memory_footprint().total_bytes());
+    }
+    BOOST_CHECK_EQUAL(stats.allocations(),stats.deallocations());
+    BOOST_CHECK_EQUAL(0,stats.live_bytes());
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_footprint)
+{
+    typedef basic_json<char,cow_policy> cow_json;
+
+    cow_json a = cow_json::parse(R"({"a":[1,2,3,4,5,6,7,8,9,10]})");
+    cow_json b = cow_json::array();
+    b.push_back(a);
+    b.push_back(a);
+    b.push_back(a);
+
+    size_t one = a.memory_footprint().total_bytes();
+    size_t all = b.memory_footprint().total_bytes();
+    BOOST_CHECK_EQUAL(one + sizeof(cow_json::array) + b.capacity()*sizeof(cow_json),all);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -0,0 +1,78 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <string>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(object_builder_tests)
+
+BOOST_AUTO_TEST_CASE(test_build_sorted_object)
+{
+    json::object_builder builder;
+    builder.reserve(4);
+    builder.push_back("c", 3);
+    builder.push_back("a", "one");
+    builder.push_back("b", json::parse("[1,2]"));
+    builder.push_back("a", 1);
+    BOOST_CHECK_EQUAL(4,builder.size());
+
+    json j = builder.build();
+    BOOST_CHECK(builder.empty());
+    BOOST_CHECK_EQUAL(std::string(R"({"a":1,"b":[1,2],"c":3})"),j.to_string());
+    BOOST_CHECK_EQUAL(1,j["a"].as<int>());
+
+    builder.push_back("z", true);
+    json k = builder.build();
+    BOOST_CHECK_EQUAL(std::string(R"({"z":true})"),k.to_string());
+
+    json empty = builder.build();
+    BOOST_CHECK(empty.is_object());
+    BOOST_CHECK_EQUAL(0,empty.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_build_preserve_order_object)
+{
+    ojson::object_builder builder;
+    builder.push_back("c", 3);
+    builder.push_back("a", 1);
+    builder.push_back("b", 2);
+    builder.push_back("c", 4);
+
+    ojson j = builder.build();
+    BOOST_CHECK_EQUAL(std::string(R"({"a":1,"b":2,"c":4})"),j.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_build_large_object)
+{
+    const size_t n = 10000;
+    json::object_builder builder;
+    for (size_t i = 0; i < n; ++i)
+    {
+        builder.push_back("key" + std::to_string((i*7919) % n), i);
+    }
+    json j = builder.build();
+    BOOST_REQUIRE(j.size() == n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK(j.has_key("key" + std::to_string(i)));
+    }
+    auto range = j.object_range();
+    BOOST_CHECK(std::is_sorted(range.begin(), range.end(),
+                               [](const json::key_value_pair_type& a, const json::key_value_pair_type& b){return a.key() < b.key();}));
+}
+
+BOOST_AUTO_TEST_CASE(test_decoder_duplicate_keys)
+{
+    json j = json::parse(R"({"b":1,"a":{},"b":2,"c":{"y":1,"x":2,"y":3}})");
+    BOOST_CHECK_EQUAL(std::string(R"({"a":{},"b":2,"c":{"x":2,"y":3}})"),j.to_string());
+    BOOST_CHECK(j["a"].is_object());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
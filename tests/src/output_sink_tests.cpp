@@ -0,0 +1,262 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/output_sink.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <cstdio>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(output_sink_tests)
+
+namespace {
+
+json make_document(size_t n)
+{
+    json a = json::array();
+    for (size_t i = 0; i < n; ++i)
+    {
+        json record;
+        record["id"] = i;
+        record["name"] = "record " + std::to_string(i);
+        record["value"] = i * 0.25;
+        a.push_back(std::move(record));
+    }
+    return a;
+}
+
+std::string dump_to_stream(const json& j, const serialization_options& options = serialization_options())
+{
+    std::ostringstream os;
+    j.dump(os, options);
+    return os.str();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_string_sink)
+{
+    json j = make_document(1000);
+    std::string expected = dump_to_stream(j);
+
+    std::string s;
+    j.dump(s);
+    BOOST_CHECK_EQUAL(expected, s);
+    BOOST_CHECK_EQUAL(expected, j.to_string());
+
+    // dump replaces the contents of the string
+    j.dump(s);
+    BOOST_CHECK_EQUAL(expected, s);
+
+    // A string_sink appends
+    std::string t = "prefix:";
+    string_sink sink(t);
+    j.dump(sink);
+    BOOST_CHECK_EQUAL("prefix:" + expected, t);
+
+    serialization_options options;
+    options.indent(2);
+    std::string pretty;
+    j.dump(pretty, options);
+    BOOST_CHECK_EQUAL(dump_to_stream(j, options), pretty);
+}
+
+BOOST_AUTO_TEST_CASE(test_small_values_to_string)
+{
+    BOOST_CHECK_EQUAL(std::string("1"), json(1).to_string());
+    BOOST_CHECK_EQUAL(std::string("\"\""), json("").to_string());
+    BOOST_CHECK_EQUAL(std::string("[]"), json(json::array()).to_string());
+    BOOST_CHECK_EQUAL(std::string("{}"), json().to_string());
+
+    wjson w = wjson::parse(L"{\"a\":[1,2,\"three\"]}");
+    std::wstring ws;
+    w.dump(ws);
+    BOOST_CHECK(ws == L"{\"a\":[1,2,\"three\"]}");
+    BOOST_CHECK(w.to_string() == L"{\"a\":[1,2,\"three\"]}");
+}
+
+BOOST_AUTO_TEST_CASE(test_fixed_buffer_sink)
+{
+    json j = make_document(10);
+    std::string expected = dump_to_stream(j);
+
+    std::vector<char> buffer(expected.length() + 10);
+    fixed_buffer_sink sink(buffer.data(), buffer.size());
+    j.dump(sink);
+    BOOST_CHECK(!sink.overflow());
+    BOOST_CHECK_EQUAL(expected.length(), sink.size());
+    BOOST_CHECK_EQUAL(expected.length(), sink.required_size());
+    BOOST_CHECK_EQUAL(expected, std::string(buffer.data(), sink.size()));
+
+    std::vector<char> exact(expected.length());
+    fixed_buffer_sink exact_sink(exact.data(), exact.size());
+    j.dump(exact_sink);
+    BOOST_CHECK(!exact_sink.overflow());
+    BOOST_CHECK_EQUAL(expected, std::string(exact.data(), exact_sink.size()));
+}
+
+BOOST_AUTO_TEST_CASE(test_fixed_buffer_sink_overflow)
+{
+    json j = make_document(100);
+    std::string expected = dump_to_stream(j);
+
+    for (size_t capacity : {0, 1, 2, 50, 1000})
+    {
+        std::vector<char> buffer(capacity + 1, 'X');
+        fixed_buffer_sink sink(buffer.data(), capacity);
+        j.dump(sink);
+        BOOST_CHECK(sink.overflow());
+        BOOST_CHECK(sink.size() <= capacity);
+        BOOST_CHECK_EQUAL(expected.length(), sink.required_size());
+        BOOST_CHECK_EQUAL(expected.substr(0, sink.size()), std::string(buffer.data(), sink.size()));
+        BOOST_CHECK_EQUAL('X', buffer[capacity]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_fd_sink)
+{
+    json j = make_document(2000);
+    std::string expected = dump_to_stream(j);
+
+    std::FILE* f = std::tmpfile();
+    BOOST_REQUIRE(f != nullptr);
+#if defined(_WIN32)
+    int fd = _fileno(f);
+#else
+    int fd = fileno(f);
+#endif
+    {
+        fd_sink sink(fd, 100);
+        j.dump(sink);
+    }
+    std::rewind(f);
+    std::string actual;
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        actual.append(buf, n);
+    }
+    std::fclose(f);
+    BOOST_CHECK_EQUAL(expected, actual);
+}
+
+BOOST_AUTO_TEST_CASE(test_fd_sink_references)
+{
+    // Long strings with and without escapes, long member names, byte
+    // strings, and more long strings than are queued before a write
+    json j = json::array();
+    for (size_t i = 0; i < 150; ++i)
+    {
+        json record;
+        record["id"] = i;
+        record[std::string(300, 'k') + std::to_string(i)] = std::string(1000 + i, static_cast<char>('a' + i % 26));
+        std::string escaped(2000, 'x');
+        escaped[i*13 % 2000] = '"';
+        escaped[(i*7 + 1000) % 2000] = '\n';
+        record["escaped"] = escaped;
+        record["short"] = "s";
+        std::vector<uint8_t> bytes(600, static_cast<uint8_t>(i));
+        record["bytes"] = json(byte_string(byte_string_view(bytes.data(), bytes.size())));
+        j.push_back(std::move(record));
+    }
+
+    for (bool pprint : {false, true})
+    {
+        std::ostringstream os;
+        j.dump(os, pprint);
+        std::string expected = os.str();
+
+        std::FILE* f = std::tmpfile();
+        BOOST_REQUIRE(f != nullptr);
+#if defined(_WIN32)
+        int fd = _fileno(f);
+#else
+        int fd = fileno(f);
+#endif
+        {
+            fd_sink sink(fd, 1024, 256);
+            BOOST_CHECK_EQUAL(256, sink.min_reference_length());
+            json_serializer serializer(sink, pprint);
+            serializer.stable_strings(true);
+            j.dump(serializer);
+        }
+        std::rewind(f);
+        std::string actual;
+        char buf[4096];
+        size_t n;
+        while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+        {
+            actual.append(buf, n);
+        }
+        std::fclose(f);
+        BOOST_CHECK(expected == actual);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_fd_sink_from_reader)
+{
+    // The reader passes strings from buffers that it reuses, so they must
+    // be copied even though the sink takes references
+    json j = json::array();
+    for (size_t i = 0; i < 200; ++i)
+    {
+        j.push_back(std::string(100 + i, static_cast<char>('a' + i % 26)));
+    }
+    std::string text = j.to_string();
+
+    std::FILE* f = std::tmpfile();
+    BOOST_REQUIRE(f != nullptr);
+#if defined(_WIN32)
+    int fd = _fileno(f);
+#else
+    int fd = fileno(f);
+#endif
+    {
+        fd_sink sink(fd, 1024, 16);
+        json_serializer serializer(sink);
+        json_filter filter(serializer);
+        std::istringstream is(text);
+        json_reader reader(is, filter);
+        reader.buffer_length(512);
+        reader.read();
+    }
+    std::rewind(f);
+    std::string actual;
+    char buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+    {
+        actual.append(buf, n);
+    }
+    std::fclose(f);
+    BOOST_CHECK(text == actual);
+}
+
+BOOST_AUTO_TEST_CASE(test_serializer_with_sink)
+{
+    std::string s;
+    string_sink sink(s);
+    {
+        json_serializer serializer(sink, true);
+        serializer.begin_json();
+        serializer.begin_array();
+        serializer.integer_value(-10);
+        serializer.string_value("a\"b");
+        serializer.end_array();
+        serializer.end_json();
+    }
+    BOOST_CHECK_EQUAL(json::parse(s), json::parse("[-10,\"a\\\"b\"]"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,332 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <thread>
+
+using namespace jsoncons;
+
+struct packing_policy : public sorted_policy
+{
+    static const bool pack_numeric_arrays = true;
+};
+
+typedef basic_json<char,packing_policy> packed_json;
+
+namespace {
+
+// Counts the bytes outstanding from each allocator id
+int64_t tagged_outstanding[3] = {0,0,0};
+
+template <class T>
+struct tagged_allocator
+{
+    typedef T value_type;
+
+    int id;
+
+    tagged_allocator()
+        : id(0)
+    {
+    }
+
+    explicit tagged_allocator(int n)
+        : id(n)
+    {
+    }
+
+    template <class U>
+    tagged_allocator(const tagged_allocator<U>& other)
+        : id(other.id)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        tagged_outstanding[id] += static_cast<int64_t>(n*sizeof(T));
+        return static_cast<T*>(::operator new(n*sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        tagged_outstanding[id] -= static_cast<int64_t>(n*sizeof(T));
+        ::operator delete(p);
+    }
+
+    template <class U>
+    struct rebind
+    {
+        typedef tagged_allocator<U> other;
+    };
+};
+
+template <class T, class U>
+bool operator==(const tagged_allocator<T>& a, const tagged_allocator<U>& b)
+{
+    return a.id == b.id;
+}
+
+template <class T, class U>
+bool operator!=(const tagged_allocator<T>& a, const tagged_allocator<U>& b)
+{
+    return a.id != b.id;
+}
+
+typedef basic_json<char,packing_policy,tagged_allocator<char>> tagged_json;
+
+}
+
+BOOST_AUTO_TEST_SUITE(packed_array_tests)
+
+BOOST_AUTO_TEST_CASE(test_is_packing_policy)
+{
+    BOOST_CHECK(!is_packing_policy<sorted_policy>::value);
+    BOOST_CHECK(!is_packing_policy<preserve_order_policy>::value);
+    BOOST_CHECK(is_packing_policy<packing_policy>::value);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_packs_homogeneous_arrays)
+{
+    std::string s = "[[1.5,2.25,-3.125,4.0,5.5,6.5,7.5,8.5],[-1,-2,-3,-4,-5,-6,-7,-8],[1,2,3,4,5,6,7,18446744073709551615],"
+                    "[1,-2,3,-4,5,-6,7,-8],[1,2.5,3,4,5,6,7,8],[1,2,3],[\"a\",\"b\",\"c\",\"d\",\"e\",\"f\",\"g\",\"h\"]]";
+    packed_json j = packed_json::parse(s);
+
+    BOOST_CHECK(j[0].array_value().is_packed());
+    BOOST_CHECK(j[0].array_value().packed().type_id() == json_type_tag::double_t);
+    BOOST_CHECK(j[1].array_value().is_packed());
+    BOOST_CHECK(j[1].array_value().packed().type_id() == json_type_tag::integer_t);
+    BOOST_CHECK(j[2].array_value().is_packed());
+    BOOST_CHECK(j[2].array_value().packed().type_id() == json_type_tag::uinteger_t);
+    BOOST_CHECK(!j[3].array_value().is_packed()); // mixed int64 and uint64
+    BOOST_CHECK(!j[4].array_value().is_packed()); // mixed uint64 and double
+    BOOST_CHECK(!j[5].array_value().is_packed()); // too short
+    BOOST_CHECK(!j[6].array_value().is_packed());
+
+    BOOST_CHECK_EQUAL(j.as<std::string>(), json::parse(s).as<std::string>());
+    BOOST_CHECK_EQUAL(8,j[0].size());
+
+    json k = json::parse(s);
+    BOOST_CHECK(!k[0].array_value().is_packed());
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_as_vector)
+{
+    packed_json j = packed_json::parse("[0.5,1.5,2.5,3.5,4.5,5.5,6.5,7.5,8.5,9.5]");
+    BOOST_REQUIRE(j.array_value().is_packed());
+
+    std::vector<double> v = j.as<std::vector<double>>();
+    BOOST_REQUIRE(v.size() == 10);
+    BOOST_CHECK_EQUAL(0.5, v[0]);
+    BOOST_CHECK_EQUAL(9.5, v[9]);
+
+    std::vector<int> w = j.as<std::vector<int>>();
+    BOOST_REQUIRE(w.size() == 10);
+    BOOST_CHECK_EQUAL(9, w[9]);
+
+    std::list<float> l = j.as<std::list<float>>();
+    BOOST_REQUIRE(l.size() == 10);
+    BOOST_CHECK_EQUAL(0.5f, l.front());
+
+    BOOST_CHECK(j.array_value().is_packed());
+
+    packed_json k = packed_json::parse("[-1,-2,-3,-4,-5,-6,-7,-8]");
+    BOOST_REQUIRE(k.array_value().is_packed());
+    std::vector<int64_t> u = k.as<std::vector<int64_t>>();
+    BOOST_REQUIRE(u.size() == 8);
+    BOOST_CHECK_EQUAL(-8, u[7]);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_push_back)
+{
+    packed_json j = packed_json::parse("[1,2,3,4,5,6,7,8]");
+
+    j.push_back(uint64_t(9));
+    BOOST_CHECK(j.array_value().is_packed());
+    BOOST_CHECK_EQUAL(9,j.size());
+
+    j.push_back("ten");
+    BOOST_CHECK(!j.array_value().is_packed());
+    BOOST_REQUIRE(j.size() == 10);
+    BOOST_CHECK_EQUAL(9,j[8].as<int>());
+    BOOST_CHECK(j[9].as<std::string>() == "ten");
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_element_access)
+{
+    const packed_json j = packed_json::parse("[1.5,2.5,3.5,4.5,5.5,6.5,7.5,8.5]");
+    packed_json k = j;
+    BOOST_CHECK(k.array_value().is_packed());
+    BOOST_CHECK(k == j);
+
+    // Const access leaves the array packed
+    BOOST_CHECK_EQUAL(3.5,j[2].as<double>());
+    BOOST_CHECK(j.array_value().is_packed());
+    double sum = 0;
+    for (const auto& element : j.array_range())
+    {
+        sum += element.as<double>();
+    }
+    BOOST_CHECK_EQUAL(40.0,sum);
+    BOOST_CHECK(j.array_value().is_packed());
+    BOOST_CHECK(k == j);
+
+    k[0] = "first";
+    BOOST_CHECK(!k.array_value().is_packed());
+    BOOST_CHECK(k[0].as<std::string>() == "first");
+    BOOST_CHECK(k != j);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_const_access_storage)
+{
+    packed_json j = packed_json::array();
+    for (int i = 0; i < 1000; ++i)
+    {
+        j.push_back(i*0.5);
+    }
+    BOOST_REQUIRE(j.array_value().pack());
+    const packed_json& c = j;
+    const size_t packed_bytes = c.array_value().heap_bytes();
+
+    // Const iteration makes each element as it is reached and keeps none
+    double sum = 0;
+    for (const auto& element : c.array_range())
+    {
+        sum += element.as<double>();
+    }
+    BOOST_CHECK_EQUAL(249750.0,sum);
+    auto it = c.array_range().begin() + 10;
+    BOOST_CHECK_EQUAL(5.0,it->as<double>());
+    BOOST_CHECK_EQUAL(1000,c.array_range().end() - c.array_range().begin());
+    BOOST_CHECK_EQUAL(packed_bytes,c.array_value().heap_bytes());
+
+    // Const access by index keeps only the block that holds the element
+    const packed_json& element = c[700];
+    BOOST_CHECK_EQUAL(350.0,element.as<double>());
+    BOOST_CHECK(&element == &c[700]);
+    BOOST_CHECK(c.array_value().heap_bytes() > packed_bytes);
+    BOOST_CHECK(c.array_value().heap_bytes() < packed_bytes + 100*sizeof(packed_json));
+    BOOST_CHECK(c.array_value().is_packed());
+
+    // A position from const iteration can be used to insert
+    j.insert(c.array_range().begin() + 1, "second");
+    BOOST_CHECK(!j.array_value().is_packed());
+    BOOST_CHECK(j[1].as<std::string>() == "second");
+    BOOST_CHECK_EQUAL(0.5,j[2].as<double>());
+    BOOST_CHECK_EQUAL(1001,j.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_concurrent_const_reads)
+{
+    std::string s = "[";
+    for (int i = 0; i < 1000; ++i)
+    {
+        if (i > 0)
+        {
+            s.push_back(',');
+        }
+        s += std::to_string(i);
+    }
+    s.push_back(']');
+    const packed_json j = packed_json::parse(s);
+    BOOST_REQUIRE(j.array_value().is_packed());
+
+    std::vector<int64_t> sums(4, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < sums.size(); ++t)
+    {
+        threads.emplace_back([&j,&sums,t]()
+        {
+            for (size_t i = 0; i < j.size(); ++i)
+            {
+                sums[t] += j[i].as<int64_t>();
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (auto sum : sums)
+    {
+        BOOST_CHECK_EQUAL(499500, sum);
+    }
+    BOOST_CHECK(j.array_value().is_packed());
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_mixed_equality_and_erase)
+{
+    packed_json packed = packed_json::parse("[1,2,3,4,5,6,7,8]");
+    packed_json doubles = packed_json::parse("[1.0,2.0,3.0,4.0,5.0,6.0,7.0,8.0]");
+    packed_json plain(packed_json::array{1,2,3,4,5,6,7,8});
+    BOOST_REQUIRE(packed.array_value().is_packed());
+    BOOST_REQUIRE(doubles.array_value().is_packed());
+    BOOST_REQUIRE(!plain.array_value().is_packed());
+    BOOST_CHECK(packed == doubles);
+    BOOST_CHECK(packed == plain);
+    BOOST_CHECK(plain == packed);
+    BOOST_CHECK(packed.array_value().is_packed());
+
+    // An iterator from const access can be used to erase
+    const packed_json& cpacked = packed;
+    auto it = cpacked.array_range().begin() + 2;
+    packed.erase(it);
+    BOOST_CHECK(!packed.array_value().is_packed());
+    BOOST_CHECK(packed == packed_json::parse("[1,2,4,5,6,7,8]"));
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_move_with_other_allocator)
+{
+    typedef tagged_json::array array_type;
+    {
+        tagged_allocator<char> alloc1(1);
+        tagged_allocator<char> alloc2(2);
+        array_type a(alloc1);
+        for (int i = 0; i < 8; ++i)
+        {
+            a.push_back(tagged_json(i));
+        }
+        BOOST_REQUIRE(a.pack());
+
+        array_type b(std::move(a), alloc2);
+        BOOST_CHECK(b.is_packed());
+        BOOST_CHECK_EQUAL(8, b.size());
+        BOOST_CHECK(tagged_outstanding[2] > 0);
+
+        // Memory from one allocator is never returned to the other
+        array_type c(std::move(b), tagged_allocator<char>(2));
+        BOOST_CHECK(c.is_packed());
+        BOOST_CHECK(!b.is_packed());
+    }
+    BOOST_CHECK_EQUAL(0, tagged_outstanding[1]);
+    BOOST_CHECK_EQUAL(0, tagged_outstanding[2]);
+}
+
+BOOST_AUTO_TEST_CASE(test_packed_cbor_msgpack)
+{
+    std::string s = "[[1.5,2.5,3.5,4.5,5.5,6.5,7.5,8.5],[-1,-200,-3,-40000,-5,-6000000000,-7,-8],[1,200,3,40000,5,6000000000,7,18446744073709551615]]";
+    packed_json j = packed_json::parse(s);
+    json k = json::parse(s);
+    BOOST_REQUIRE(j[0].array_value().is_packed());
+    BOOST_REQUIRE(j[1].array_value().is_packed());
+    BOOST_REQUIRE(j[2].array_value().is_packed());
+
+    std::vector<uint8_t> v1 = cbor::encode_cbor(j);
+    std::vector<uint8_t> v2 = cbor::encode_cbor(k);
+    BOOST_CHECK(v1 == v2);
+
+    std::vector<uint8_t> w1 = msgpack::encode_msgpack(j);
+    std::vector<uint8_t> w2 = msgpack::encode_msgpack(k);
+    BOOST_CHECK(w1 == w2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
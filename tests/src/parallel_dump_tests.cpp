@@ -0,0 +1,167 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/parallel_dump.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+namespace {
+
+struct parallel_packing_policy : public sorted_policy
+{
+    static const bool pack_numeric_arrays = true;
+};
+
+typedef basic_json<char,parallel_packing_policy> packed_json;
+
+json make_record(size_t i)
+{
+    json record;
+    record["id"] = i;
+    record["name"] = "item \"" + std::to_string(i) + "\"";
+    record["values"] = json::array{1, 2.5, "three"};
+    record["nested"] = json::parse(R"({"a":[[1,2],[3]],"b":{}})");
+    return record;
+}
+
+json make_document()
+{
+    json doc;
+    json records = json::array();
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        records.push_back(make_record(i));
+    }
+    doc["records"] = std::move(records);
+
+    json lookup;
+    for (size_t i = 0; i < 300; ++i)
+    {
+        lookup["key" + std::to_string(i)] = json::array{i, i*2};
+    }
+    doc["lookup"] = std::move(lookup);
+
+    json matrix = json::array();
+    for (size_t i = 0; i < 100; ++i)
+    {
+        json row = json::array();
+        for (size_t j = 0; j < 50; ++j)
+        {
+            row.push_back(i*j);
+        }
+        matrix.push_back(std::move(row));
+    }
+    doc["matrix"] = std::move(matrix);
+    doc["small"] = json::array{1, 2, 3};
+    doc["empty"] = json::array();
+    return doc;
+}
+
+std::vector<serialization_options> make_options()
+{
+    std::vector<serialization_options> result(3);
+    result[1].indent(2);
+    result[2].object_object_split_lines(line_split_kind::new_line)
+             .array_object_split_lines(line_split_kind::same_line)
+             .object_array_split_lines(line_split_kind::multi_line)
+             .array_array_split_lines(line_split_kind::new_line);
+    return result;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(parallel_dump_tests)
+
+BOOST_AUTO_TEST_CASE(test_parallel_dump_matches_dump)
+{
+    json doc = make_document();
+
+    for (const auto& options : make_options())
+    {
+        for (bool pprint : {false, true})
+        {
+            std::ostringstream expected;
+            doc.dump(expected, options, pprint);
+            for (size_t num_threads : {1, 2, 3, 8})
+            {
+                std::ostringstream actual;
+                parallel_dump(doc, actual, options, pprint, num_threads);
+                BOOST_CHECK_EQUAL(expected.str(), actual.str());
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_dump_top_level)
+{
+    json records = json::array();
+    for (size_t i = 0; i < 500; ++i)
+    {
+        records.push_back(make_record(i));
+    }
+    std::string expected;
+    records.dump(expected);
+
+    std::string actual;
+    string_sink sink(actual);
+    parallel_dump(records, sink);
+    BOOST_CHECK_EQUAL(expected, actual);
+
+    std::ostringstream os;
+    parallel_dump(records, os);
+    BOOST_CHECK_EQUAL(expected, os.str());
+
+    std::ostringstream scalar;
+    parallel_dump(json(10), scalar);
+    BOOST_CHECK_EQUAL(std::string("10"), scalar.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_dump_packed)
+{
+    packed_json a = packed_json::parse("[" + [](){
+        std::string s;
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            s += (i > 0 ? "," : "") + std::to_string(i*0.5);
+        }
+        return s;
+    }() + "]");
+    BOOST_REQUIRE(a.array_value().is_packed());
+
+    for (bool pprint : {false, true})
+    {
+        std::ostringstream expected;
+        a.dump(expected, serialization_options(), pprint);
+        std::ostringstream actual;
+        parallel_dump(a, actual, serialization_options(), pprint, 4);
+        BOOST_CHECK_EQUAL(expected.str(), actual.str());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_dump_wide)
+{
+    wjson a = wjson::array();
+    for (size_t i = 0; i < 200; ++i)
+    {
+        wjson record;
+        record[L"id"] = i;
+        record[L"name"] = L"né";
+        a.push_back(std::move(record));
+    }
+    std::wostringstream expected;
+    a.dump(expected, wserialization_options(), true);
+    std::wostringstream actual;
+    parallel_dump(a, actual, wserialization_options(), true, 3);
+    BOOST_CHECK(expected.str() == actual.str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
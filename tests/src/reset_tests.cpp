@@ -0,0 +1,169 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_serializer.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(reset_tests)
+
+BOOST_AUTO_TEST_CASE(test_serializer_reset_sink)
+{
+    json val = json::parse(R"({"a":[1,2.5,"three"],"b":{"c":null}})");
+
+    std::string abandoned;
+    string_sink sink1(abandoned);
+    json_serializer serializer(sink1, true);
+    serializer.begin_json();
+    serializer.begin_object();
+    serializer.name("x");
+    serializer.begin_array();
+    serializer.integer_value(1);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        std::string s;
+        string_sink sink(s);
+        serializer.reset(sink);
+        val.dump_fragment(serializer);
+        serializer.end_json();
+
+        std::ostringstream expected;
+        val.dump(expected, true);
+        BOOST_CHECK_EQUAL(expected.str(), s);
+    }
+    // Output buffered before the first reset went to the first sink
+    BOOST_CHECK(abandoned.find("\"x\"") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_serializer_reset_stream)
+{
+    serialization_options options;
+    options.cache_escaped_keys(true);
+
+    std::ostringstream os1;
+    json_serializer serializer(os1, options);
+    json::parse(R"([{"id":1},{"id":2}])").dump(serializer);
+    BOOST_CHECK_EQUAL(std::string(R"([{"id":1},{"id":2}])"), os1.str());
+
+    std::ostringstream os2;
+    serializer.reset(os2);
+    json::parse(R"({"id":3})").dump(serializer);
+    BOOST_CHECK_EQUAL(std::string(R"({"id":3})"), os2.str());
+    BOOST_CHECK_EQUAL(std::string(R"([{"id":1},{"id":2}])"), os1.str());
+
+    // A sink after a stream, and a stream again
+    std::string s;
+    string_sink sink(s);
+    serializer.reset(sink);
+    json(true).dump(serializer);
+    BOOST_CHECK_EQUAL(std::string("true"), s);
+
+    std::ostringstream os3;
+    serializer.reset(os3);
+    json(json::array()).dump(serializer);
+    BOOST_CHECK_EQUAL(std::string("[]"), os3.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_serializer_reset_discards)
+{
+    std::string s;
+    string_sink sink(s);
+    json_serializer serializer(sink);
+    serializer.begin_json();
+    serializer.begin_object();
+    serializer.name("x");
+    serializer.begin_array();
+    serializer.integer_value(1);
+
+    serializer.reset();
+    json::parse("[2]").dump(serializer);
+    BOOST_CHECK_EQUAL(std::string("[2]"), s);
+
+    std::ostringstream os;
+    json_serializer stream_serializer(os, true);
+    stream_serializer.begin_json();
+    stream_serializer.begin_array();
+    stream_serializer.string_value("abandoned");
+
+    stream_serializer.reset();
+    json(json::object()).dump(stream_serializer);
+    BOOST_CHECK_EQUAL(std::string("{}"), os.str());
+}
+
+BOOST_AUTO_TEST_CASE(test_parser_and_decoder_reset)
+{
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+
+    std::string s1 = R"({"a":[1,2,{"b":"cé"}]})";
+    parser.set_source(s1.data(), s1.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    BOOST_CHECK(decoder.get_result() == json::parse(s1));
+
+    // Stop in the middle of a string escape, a number and nested containers
+    std::string s2 = R"({"a":[1,{"b":"\u00)";
+    parser.reset();
+    decoder.reset();
+    parser.set_source(s2.data(), s2.length());
+    std::error_code ec;
+    parser.parse(ec);
+    BOOST_CHECK(!ec);
+    BOOST_CHECK(!parser.done());
+
+    std::string s3 = R"([-12.5e1,"x",[]])";
+    parser.reset();
+    decoder.reset();
+    BOOST_CHECK(!decoder.is_valid());
+    parser.set_source(s3.data(), s3.length());
+    parser.parse();
+    parser.end_parse();
+    parser.check_done();
+    BOOST_CHECK_EQUAL(1, parser.line_number());
+    BOOST_CHECK(decoder.is_valid());
+    BOOST_CHECK(decoder.get_result() == json::parse(s3));
+}
+
+BOOST_AUTO_TEST_CASE(test_reader_reset)
+{
+    json_decoder<json> decoder;
+    std::istringstream is1(R"({"a":1})");
+    json_reader reader(is1, decoder);
+    reader.read();
+    BOOST_CHECK(decoder.get_result() == json::parse(R"({"a":1})"));
+
+    std::istringstream is2("\xEF\xBB\xBF[1,2,3]");
+    reader.reset(is2);
+    decoder.reset();
+    reader.read();
+    BOOST_CHECK(decoder.get_result() == json::parse("[1,2,3]"));
+
+    // A reader that failed can be reset and read another stream
+    std::istringstream is3("[1,2");
+    reader.reset(is3);
+    decoder.reset();
+    std::error_code ec;
+    reader.read(ec);
+    BOOST_CHECK(ec);
+
+    std::istringstream is4("\"done\"");
+    reader.reset(is4);
+    decoder.reset();
+    reader.read();
+    BOOST_CHECK_EQUAL(std::string("done"), decoder.get_result().as<std::string>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(serialized_size_tests)
+
+BOOST_AUTO_TEST_CASE(test_serialized_size)
+{
+    std::vector<json> values = {
+        json(),
+        json(json::array()),
+        json(0),
+        json(-1234567890123),
+        json((std::numeric_limits<uint64_t>::max)()),
+        json(0.1),
+        json(1e300),
+        json(-2.5e-300),
+        json(""),
+        json("plain"),
+        json("quote \" reverse solidus \\ solidus / newline \n control \x01 del \x7f"),
+        json("caf\xC3\xA9 \xF0\x9D\x84\x9E"),
+        json::parse(R"({"a":[1,2.5,"x",null,true,false,{}],"b":{"c":[[]]},"d":"\u0000"})")
+    };
+
+    serialization_options escaping;
+    escaping.escape_all_non_ascii(true).escape_solidus(true);
+    serialization_options precision;
+    precision.precision(4);
+    serialization_options indented;
+    indented.indent(2);
+
+    for (const auto& val : values)
+    {
+        for (const auto& options : {serialization_options(), escaping, precision, indented})
+        {
+            std::string s;
+            val.dump(s, options);
+            BOOST_CHECK_EQUAL(s.length(), serialized_size(val, options));
+        }
+        std::string s;
+        val.dump(s);
+        BOOST_CHECK_EQUAL(s.length(), serialized_size(val));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_serialized_size_large)
+{
+    json a = json::array();
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        a.push_back(json::parse(R"({"id":)" + std::to_string(i) + R"(,"name":"item \")" + std::to_string(i) + R"(\""})"));
+    }
+    std::string s;
+    a.dump(s);
+    BOOST_CHECK_EQUAL(s.length(), serialized_size(a));
+
+    wjson w = wjson::parse(L"[\"wide\",1,2.5]");
+    std::wstring ws;
+    w.dump(ws);
+    BOOST_CHECK_EQUAL(ws.length(), serialized_size(w));
+}
+
+BOOST_AUTO_TEST_CASE(test_dump_to_exact_buffer)
+{
+    json j = json::parse(R"({"id":42,"tags":["a","b\n"],"score":0.75})");
+    std::string expected;
+    j.dump(expected);
+
+    size_t n = serialized_size(j);
+    std::vector<char> buffer(n);
+    BOOST_CHECK_EQUAL(n, j.dump(buffer.data(), buffer.size()));
+    BOOST_CHECK_EQUAL(expected, std::string(buffer.data(), n));
+
+    serialization_options options;
+    options.indent(4);
+    size_t m = serialized_size(j, options);
+    std::vector<char> pretty(m);
+    BOOST_CHECK_EQUAL(m, j.dump(pretty.data(), pretty.size(), options));
+    std::string pretty_expected;
+    j.dump(pretty_expected, options);
+    BOOST_CHECK_EQUAL(pretty_expected, std::string(pretty.data(), m));
+}
+
+BOOST_AUTO_TEST_CASE(test_dump_to_short_buffer)
+{
+    json j = json::parse(R"({"id":42})");
+    std::vector<char> buffer(serialized_size(j) - 1);
+    BOOST_CHECK_THROW(j.dump(buffer.data(), buffer.size()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,141 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/shared_json.hpp>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+using namespace jsoncons;
+
+struct packing_cow_policy : public sorted_policy
+{
+    static const bool pack_numeric_arrays = true;
+    static const bool copy_on_write = true;
+};
+
+BOOST_AUTO_TEST_SUITE(shared_json_tests)
+
+BOOST_AUTO_TEST_CASE(test_shared_json_copy)
+{
+    shared_json a = shared_json::parse(R"({"name":"snapshot","values":[1,2,3]})");
+    BOOST_REQUIRE(a);
+    BOOST_CHECK_EQUAL(1,a.use_count());
+
+    shared_json b = a;
+    BOOST_CHECK_EQUAL(2,a.use_count());
+    BOOST_CHECK(&(*a) == &(*b));
+    BOOST_CHECK(a->at("name").as<std::string>() == "snapshot");
+    BOOST_CHECK_EQUAL(3,b->at("values").size());
+
+    shared_json c;
+    BOOST_CHECK(!c);
+    BOOST_CHECK(c != a);
+    c = shared_json(json::parse(R"({"values":[1,2,3],"name":"snapshot"})"));
+    BOOST_CHECK(c == a);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_json_empty_object_const_access)
+{
+    json j;
+    BOOST_CHECK(j.object_value().size() == 0);
+
+    const json k;
+    BOOST_CHECK(k.object_value().size() == 0);
+    BOOST_CHECK(k.object_range().begin() == k.object_range().end());
+    BOOST_CHECK(k.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_json_keeps_packed_arrays)
+{
+    typedef basic_json<char,packing_cow_policy> Json;
+
+    Json j = Json::parse(R"({"a":[1,2,3,4,5,6,7,8],"b":[[0.5,1.5,2.5,3.5,4.5,5.5,6.5,7.5]]})");
+    BOOST_REQUIRE(j.at("a").array_value().is_packed());
+
+    basic_shared_json<Json> s(std::move(j));
+    const Json& doc = *s;
+    BOOST_CHECK(doc["a"].array_value().is_packed());
+    BOOST_CHECK(doc["b"][0].array_value().is_packed());
+
+    std::vector<std::thread> readers;
+    std::atomic<size_t> errors(0);
+    for (size_t t = 0; t < 4; ++t)
+    {
+        readers.emplace_back([&doc,&errors]()
+        {
+            int64_t sum = 0;
+            for (const auto& element : doc["a"].array_range())
+            {
+                sum += element.as<int64_t>();
+            }
+            if (sum != 36 || doc["a"][7].as<int>() != 8 || doc["b"][0][1].as<double>() != 1.5)
+            {
+                ++errors;
+            }
+        });
+    }
+    for (auto& t : readers)
+    {
+        t.join();
+    }
+    BOOST_CHECK_EQUAL(0,errors.load());
+    BOOST_CHECK(doc["a"].array_value().is_packed());
+    BOOST_CHECK(doc["b"][0].array_value().is_packed());
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_json_atomic_swap)
+{
+    shared_json current = shared_json::parse(R"({"version":0,"data":[0,1,2,3,4,5,6,7,8,9]})");
+
+    std::atomic<bool> done(false);
+    std::atomic<size_t> errors(0);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&]()
+        {
+            while (!done.load())
+            {
+                shared_json snapshot = atomic_load(&current);
+                int version = snapshot->at("version").as<int>();
+                const json& data = snapshot->at("data");
+                for (size_t k = 0; k < data.size(); ++k)
+                {
+                    if (data[k].as<int>() != version + static_cast<int>(k))
+                    {
+                        ++errors;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int version = 1; version <= 100; ++version)
+    {
+        json doc;
+        doc["version"] = version;
+        doc["data"] = json::array();
+        for (int k = 0; k < 10; ++k)
+        {
+            doc["data"].push_back(version + k);
+        }
+        shared_json previous = atomic_exchange(&current, shared_json(std::move(doc)));
+        BOOST_CHECK_EQUAL(version-1,previous->at("version").as<int>());
+    }
+    done = true;
+    for (auto& t : readers)
+    {
+        t.join();
+    }
+    BOOST_CHECK_EQUAL(0,errors.load());
+    BOOST_CHECK_EQUAL(100,atomic_load(&current)->at("version").as<int>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
@@ -18,6 +18,50 @@
 
 using namespace jsoncons;
 
+namespace {
+
+struct small_string_22_policy : public sorted_policy
+{
+    static const size_t small_string_capacity = 22;
+};
+
+struct small_string_30_policy : public preserve_order_policy
+{
+    static const size_t small_string_capacity = 30;
+};
+
+// Does not derive from sorted_policy, so takes the default capacity
+struct custom_policy
+{
+    static const bool preserve_order = false;
+
+    template <class T,class Allocator>
+    using object_storage = std::vector<T,Allocator>;
+
+    template <class T,class Allocator>
+    using array_storage = std::vector<T,Allocator>;
+
+    template <class CharT, class CharTraits, class Allocator>
+    using key_storage = std::basic_string<CharT, CharTraits,Allocator>;
+
+    template <class CharT, class CharTraits, class Allocator>
+    using string_storage = std::basic_string<CharT, CharTraits,Allocator>;
+
+    typedef default_parse_error_handler parse_error_handler_type;
+};
+
+typedef basic_json<char,small_string_22_policy> json22;
+typedef basic_json<char,small_string_30_policy> ojson30;
+typedef basic_json<wchar_t,small_string_30_policy> wojson30;
+
+template <class Json>
+bool is_inline(const Json& j)
+{
+    return j.type_id() == json_type_tag::small_string_t;
+}
+
+}
+
 BOOST_AUTO_TEST_SUITE(small_string_tests)
 
 BOOST_AUTO_TEST_CASE(test_small_string)
@@ -36,5 +80,51 @@ BOOST_AUTO_TEST_CASE(test_small_string)
     BOOST_CHECK(q.as<std::string>() == std::string("ABCD"));
 }
 
+BOOST_AUTO_TEST_CASE(test_value_size)
+{
+    BOOST_CHECK_EQUAL(14,small_string_capacity_of<custom_policy>::value);
+    BOOST_CHECK_EQUAL(22,small_string_capacity_of<small_string_22_policy>::value);
+    BOOST_CHECK(sizeof(basic_json<char,custom_policy>) == sizeof(json));
+    if (sizeof(void*) == 8)
+    {
+        BOOST_CHECK_EQUAL(16,sizeof(json));
+        BOOST_CHECK_EQUAL(24,sizeof(json22));
+        BOOST_CHECK_EQUAL(32,sizeof(ojson30));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_inline_length)
+{
+    std::string s21(21,'a');
+    std::string s22(22,'b');
+    BOOST_CHECK(is_inline(json22(s21)));
+    BOOST_CHECK(!is_inline(json22(s22)));
+    BOOST_CHECK(!is_inline(json(s21)));
+
+    std::string s29(29,'c');
+    BOOST_CHECK(is_inline(ojson30(s29)));
+    BOOST_CHECK(!is_inline(ojson30(s29 + "d")));
+
+    std::wstring w(30/sizeof(wchar_t) - 1,L'w');
+    BOOST_CHECK(is_inline(wojson30(w)));
+    BOOST_CHECK(!is_inline(wojson30(w + L"x")));
+    BOOST_CHECK(wojson30(w).as<std::wstring>() == w);
+}
+
+BOOST_AUTO_TEST_CASE(test_round_trip)
+{
+    std::string s = R"({"short":"abc","twenty one characters":"aaaaaaaaaaaaaaaaaaaaa","long":"aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"})";
+    json22 j = json22::parse(s);
+    BOOST_CHECK_EQUAL(json::parse(s).to_string(),j.to_string());
+    BOOST_CHECK(is_inline(j["twenty one characters"]));
+    BOOST_CHECK(j["twenty one characters"].as<std::string>() == std::string(21,'a'));
+
+    json22 k = j;
+    BOOST_CHECK(j == k);
+    k["twenty one characters"] = std::string(21,'b');
+    BOOST_CHECK(j != k);
+    BOOST_CHECK(k["twenty one characters"].as_string_view() == std::string(21,'b'));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -0,0 +1,146 @@
+// Copyright 2013 Daniel Parker
+// Distributed under Boost license
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/small_vector.hpp>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+typedef basic_json<char,small_storage_policy> small_json;
+typedef basic_json<char,preserve_order_small_storage_policy> small_ojson;
+
+BOOST_AUTO_TEST_SUITE(small_vector_tests)
+
+BOOST_AUTO_TEST_CASE(test_small_vector_inline_and_heap)
+{
+    small_vector<std::string,2> v;
+    BOOST_CHECK(v.is_inline());
+    BOOST_CHECK_EQUAL(2,v.capacity());
+
+    v.push_back("a string longer than the short string buffer");
+    v.emplace_back("b");
+    BOOST_CHECK(v.is_inline());
+
+    v.emplace_back(v[0]);
+    BOOST_CHECK(!v.is_inline());
+    BOOST_REQUIRE(v.size() == 3);
+    BOOST_CHECK(v[2] == v[0]);
+
+    v.erase(v.begin());
+    v.erase(v.begin());
+    v.shrink_to_fit();
+    BOOST_CHECK(v.is_inline());
+    BOOST_REQUIRE(v.size() == 1);
+    BOOST_CHECK(v[0] == "a string longer than the short string buffer");
+}
+
+BOOST_AUTO_TEST_CASE(test_small_vector_insert_erase)
+{
+    small_vector<int,4> v = {1,2,5};
+    v.insert(v.begin()+2, 4);
+    v.emplace(v.begin()+2, 3);
+    BOOST_CHECK(!v.is_inline());
+    std::vector<int> w = {6,7};
+    v.insert(v.end(), w.begin(), w.end());
+    v.insert(v.begin(), 0);
+    BOOST_REQUIRE(v.size() == 8);
+    for (int i = 0; i < 8; ++i)
+    {
+        BOOST_CHECK_EQUAL(i,v[i]);
+    }
+    v.erase(v.begin()+1,v.begin()+7);
+    BOOST_REQUIRE(v.size() == 2);
+    BOOST_CHECK_EQUAL(7,v.back());
+
+    v.resize(5,9);
+    BOOST_CHECK(v == (small_vector<int,4>{0,7,9,9,9}));
+}
+
+BOOST_AUTO_TEST_CASE(test_small_vector_copy_move_swap)
+{
+    small_vector<std::string,2> a = {"a"};
+    small_vector<std::string,2> b = {"x","y","z"};
+
+    small_vector<std::string,2> c(a);
+    small_vector<std::string,2> d(std::move(b));
+    BOOST_CHECK(c == a);
+    BOOST_CHECK(b.empty());
+    BOOST_REQUIRE(d.size() == 3);
+
+    c.swap(d);
+    BOOST_CHECK(c.size() == 3 && c[2] == "z");
+    BOOST_CHECK(d.size() == 1 && d[0] == "a");
+    BOOST_CHECK(d.is_inline());
+
+    b = std::move(c);
+    BOOST_CHECK(b.size() == 3 && b[0] == "x");
+    a = b;
+    BOOST_CHECK(a == b);
+}
+
+BOOST_AUTO_TEST_CASE(test_small_storage_json)
+{
+    std::string s = R"({"tags":["a","b"],"point":[1.5,2.5],"rec":{"id":1,"name":"n"},"list":[1,2,3,4,5,6,7,8,9,10],)"
+                    R"("wide":{"k1":1,"k2":2,"k3":3,"k4":4,"k5":5,"k6":6,"k7":7,"k8":8,"k9":9,"k10":10}})";
+    small_json j = small_json::parse(s);
+    json k = json::parse(s);
+    BOOST_CHECK_EQUAL(j.to_string(),k.to_string());
+
+    BOOST_CHECK_EQUAL(2,j["tags"].size());
+    BOOST_CHECK(j["rec"]["name"].as<std::string>() == "n");
+    BOOST_CHECK_EQUAL(10,j["wide"]["k10"].as<int>());
+    BOOST_CHECK(!j["wide"].has_key("k11"));
+    BOOST_CHECK(!j["rec"].has_key("x"));
+
+    small_json c = j;
+    c["rec"]["age"] = 30;
+    c["tags"].insert(c["tags"].array_range().begin(),"first");
+    c["list"].erase(c["list"].array_range().begin(),c["list"].array_range().begin()+8);
+    c["wide"].erase("k1");
+    BOOST_CHECK_EQUAL(30,c["rec"]["age"].as<int>());
+    BOOST_CHECK(c["tags"][0].as<std::string>() == "first");
+    BOOST_CHECK_EQUAL(2,c["list"].size());
+    BOOST_CHECK_EQUAL(9,c["wide"].size());
+    BOOST_CHECK(j != c);
+
+    small_json m = small_json::parse(R"({"b":2})");
+    m.merge(small_json::parse(R"({"a":1,"b":3,"c":4})"));
+    BOOST_CHECK_EQUAL(std::string(R"({"a":1,"b":2,"c":4})"),m.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_small_storage_ojson)
+{
+    small_ojson j = small_ojson::parse(R"({"b":1,"a":[1,2],"c":{"z":1,"y":2}})");
+    j["d"] = 4;
+    j["a"].push_back(3);
+    BOOST_CHECK_EQUAL(std::string(R"({"b":1,"a":[1,2,3],"c":{"z":1,"y":2},"d":4})"),j.to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_linear_search_threshold)
+{
+    BOOST_CHECK_EQUAL(0,linear_search_threshold_of<sorted_policy>::value);
+    BOOST_CHECK_EQUAL(8,linear_search_threshold_of<small_storage_policy>::value);
+    BOOST_CHECK_EQUAL(8,linear_search_threshold_of<preserve_order_small_storage_policy>::value);
+
+    small_json j;
+    for (size_t i = 0; i < 12; ++i)
+    {
+        std::string key = "key" + std::to_string(11-i);
+        j[key] = i;
+        for (size_t k = 0; k <= i; ++k)
+        {
+            BOOST_CHECK(j.has_key("key" + std::to_string(11-k)));
+        }
+        BOOST_CHECK(!j.has_key("key"));
+        BOOST_CHECK(!j.has_key("key99"));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+